@@ -0,0 +1,159 @@
+/**
+	SexyOS
+	Checksum.cpp
+	Przeznaczenie: Zawiera definicje metod dla klasy z Checksum.h
+
+	@version 19/10/26
+*/
+
+#include "Checksum.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHECKSUM_X86
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+//Kompilator Microsoftu pozwala używać instrukcji SSE4.2 bez oznaczania funkcji
+#define CHECKSUM_TARGET
+#else
+#define CHECKSUM_TARGET __attribute__((target("sse4.2")))
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#define CHECKSUM_ARM
+#include <arm_acle.h>
+#endif
+
+namespace {
+	//Liczba bloków, których sumy liczone są na przemian
+	const size_t INTERLEAVE = 4;
+
+	//Odczyt 8 bajtów spod dowolnego (niewyrównanego) adresu
+	inline uint64_t Load64(const char *data) {
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	//Tablice wersji przenośnej - tablica k przesuwa bajt o k pozycji dalej (odwrócony wielomian 0x82F63B78)
+	const std::array<std::array<uint32_t, 256>, 8> &Tables() {
+		static const std::array<std::array<uint32_t, 256>, 8> tables = [] {
+			std::array<std::array<uint32_t, 256>, 8> result{};
+			for (uint32_t byte = 0; byte < 256; byte++) {
+				uint32_t crc = byte;
+				for (int bit = 0; bit < 8; bit++) { crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1; }
+				result[0][byte] = crc;
+			}
+			for (uint32_t byte = 0; byte < 256; byte++) {
+				for (int k = 1; k < 8; k++) { result[k][byte] = (result[k - 1][byte] >> 8) ^ result[0][result[k - 1][byte] & 0xFF]; }
+			}
+			return result;
+		}();
+		return tables;
+	}
+
+	uint32_t SoftwareCrc32c(uint32_t crc, const char *data, size_t length) {
+		const std::array<std::array<uint32_t, 256>, 8> &t = Tables();
+		const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+		//8 bajtów na krok (dane w kolejności little-endian, jak na x86 i ARM)
+		for (; length >= 8; length -= 8, bytes += 8) {
+			const uint32_t low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24);
+			crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+				^ t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+		}
+		for (; length > 0; length--, bytes++) { crc = (crc >> 8) ^ t[0][(crc ^ *bytes) & 0xFF]; }
+		return crc;
+	}
+
+#if defined(CHECKSUM_X86)
+	const bool CpuSupportsCrc32c() {
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 20)) != 0;
+#else
+		return __builtin_cpu_supports("sse4.2");
+#endif
+	}
+
+	CHECKSUM_TARGET uint32_t HardwareCrc32c(uint32_t crc, const char *data, size_t length) {
+		uint64_t crc64 = crc;
+		for (; length >= 8; length -= 8, data += 8) { crc64 = _mm_crc32_u64(crc64, Load64(data)); }
+		crc = (uint32_t)crc64;
+		for (; length > 0; length--, data++) { crc = _mm_crc32_u8(crc, (unsigned char)*data); }
+		return crc;
+	}
+
+	CHECKSUM_TARGET void HardwareCrc32cBlocks(const char *data, const size_t blockSize, size_t blockCount, unsigned int *checksums) {
+		//Każdy blok to osobny łańcuch zależności, więc instrukcje kilku bloków wykonują się równolegle
+		for (; blockCount >= INTERLEAVE; blockCount -= INTERLEAVE, data += INTERLEAVE * blockSize, checksums += INTERLEAVE) {
+			uint64_t crc[INTERLEAVE] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+			size_t offset = 0;
+			for (; offset + 8 <= blockSize; offset += 8) {
+				for (size_t i = 0; i < INTERLEAVE; i++) { crc[i] = _mm_crc32_u64(crc[i], Load64(data + i * blockSize + offset)); }
+			}
+			for (size_t i = 0; i < INTERLEAVE; i++) {
+				checksums[i] = ~HardwareCrc32c((uint32_t)crc[i], data + i * blockSize + offset, blockSize - offset);
+			}
+		}
+		for (; blockCount > 0; blockCount--, data += blockSize, checksums++) { checksums[0] = ~HardwareCrc32c(0xFFFFFFFF, data, blockSize); }
+	}
+#elif defined(CHECKSUM_ARM)
+	const bool CpuSupportsCrc32c() { return true; }
+
+	uint32_t HardwareCrc32c(uint32_t crc, const char *data, size_t length) {
+		for (; length >= 8; length -= 8, data += 8) { crc = __crc32cd(crc, Load64(data)); }
+		for (; length > 0; length--, data++) { crc = __crc32cb(crc, (unsigned char)*data); }
+		return crc;
+	}
+
+	void HardwareCrc32cBlocks(const char *data, const size_t blockSize, size_t blockCount, unsigned int *checksums) {
+		for (; blockCount >= INTERLEAVE; blockCount -= INTERLEAVE, data += INTERLEAVE * blockSize, checksums += INTERLEAVE) {
+			uint32_t crc[INTERLEAVE] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+			size_t offset = 0;
+			for (; offset + 8 <= blockSize; offset += 8) {
+				for (size_t i = 0; i < INTERLEAVE; i++) { crc[i] = __crc32cd(crc[i], Load64(data + i * blockSize + offset)); }
+			}
+			for (size_t i = 0; i < INTERLEAVE; i++) {
+				checksums[i] = ~HardwareCrc32c(crc[i], data + i * blockSize + offset, blockSize - offset);
+			}
+		}
+		for (; blockCount > 0; blockCount--, data += blockSize, checksums++) { checksums[0] = ~HardwareCrc32c(0xFFFFFFFF, data, blockSize); }
+	}
+#endif
+
+	//Wybór wersji przy pierwszym użyciu
+	const bool UseHardware() {
+#if defined(CHECKSUM_X86) || defined(CHECKSUM_ARM)
+		static const bool hardware = CpuSupportsCrc32c();
+#else
+		static const bool hardware = false;
+#endif
+		return hardware;
+	}
+}
+
+const unsigned int Checksum::Crc32c(const char *data, const size_t &length) {
+#if defined(CHECKSUM_X86) || defined(CHECKSUM_ARM)
+	if (UseHardware()) { return ~HardwareCrc32c(0xFFFFFFFF, data, length); }
+#endif
+	return ~SoftwareCrc32c(0xFFFFFFFF, data, length);
+}
+
+void Checksum::Crc32cBlocks(const char *data, const size_t &blockSize, const size_t &blockCount, unsigned int *checksums) {
+#if defined(CHECKSUM_X86) || defined(CHECKSUM_ARM)
+	if (UseHardware()) {
+		HardwareCrc32cBlocks(data, blockSize, blockCount, checksums);
+		return;
+	}
+#endif
+	for (size_t block = 0; block < blockCount; block++) {
+		checksums[block] = ~SoftwareCrc32c(0xFFFFFFFF, data + block * blockSize, blockSize);
+	}
+}
+
+const bool Checksum::HardwareAccelerated() {
+	return UseHardware();
+}
@@ -0,0 +1,53 @@
+/**
+	SexyOS
+	Checksum.h
+	Przeznaczenie: Zawiera klasę Checksum - sumy kontrolne CRC32C liczone sprzętowo, jeśli procesor to umożliwia
+
+	@version 19/10/26
+*/
+
+#ifndef SEXYOS_CHECKSUM_H
+#define SEXYOS_CHECKSUM_H
+
+#include <cstddef>
+
+/*
+	Sumy kontrolne CRC32C (wielomian Castagnoli). Na procesorach x86-64 z SSE4.2
+	używana jest instrukcja crc32, na procesorach ARM z rozszerzeniem CRC - crc32c,
+	a w pozostałych przypadkach przenośna wersja tablicowa (8 bajtów na krok).
+	Wybór wersji następuje w czasie działania programu, więc nie są potrzebne
+	żadne dodatkowe flagi kompilatora.
+*/
+class Checksum {
+public:
+	/**
+		Liczy sumę kontrolną CRC32C danych.
+
+		@param data Wskaźnik na początek danych.
+		@param length Długość danych (bajty).
+		@return Suma kontrolna.
+	*/
+	static const unsigned int Crc32c(const char *data, const size_t &length);
+
+	/**
+		Liczy sumy kontrolne CRC32C kolejnych bloków leżących w pamięci jeden za drugim.
+		Sumy kilku bloków liczone są na przemian, więc instrukcje sprzętowe kolejnych
+		bloków nie czekają na siebie i przepustowość zbliża się do przepustowości pamięci.
+
+		@param data Wskaźnik na początek pierwszego bloku.
+		@param blockSize Rozmiar bloku (bajty).
+		@param blockCount Liczba bloków.
+		@param checksums Tablica, do której zapisywane są sumy kontrolne (blockCount elementów).
+		@return void.
+	*/
+	static void Crc32cBlocks(const char *data, const size_t &blockSize, const size_t &blockCount, unsigned int *checksums);
+
+	/**
+		Sprawdza, czy sumy kontrolne liczone są sprzętowo.
+
+		@return Prawda, jeśli używane są instrukcje procesora, inaczej fałsz.
+	*/
+	static const bool HardwareAccelerated();
+};
+
+#endif //SEXYOS_CHECKSUM_H
@@ -10,6 +10,11 @@
 #include "FileManager.h"
 #include <algorithm>
 #include <iomanip>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 //Operator do wywietlania czasu z dat
 std::ostream& operator << (std::ostream &os, const tm &time) {
@@ -17,34 +22,74 @@ std::ostream& operator << (std::ostream &os, const tm &time) {
 	return os;
 }
 
+//Definicje staych statycznych (potrzebne, gdy staa przekazywana jest przez referencj)
+const unsigned int FileManager::BLOCK_SIZE;
+const unsigned int FileManager::IMAGE_MAGIC;
+const unsigned int FileManager::IMAGE_VERSION;
+
 //--------------------------- Dysk --------------------------
 
-FileManager::Disk::Disk() {
+FileManager::Disk::Disk(const unsigned int &deviceCount) {
 	//Zapenanie naszego dysku zerowymi bajtami (symbolizuje pusty dysk)
-	fill(space.begin(), space.end(), NULL);
+	Stripe(deviceCount);
+	UpdateChecksums(0, DISK_CAPACITY - 1);
 }
 
 FileManager::Disk::FAT::FAT() {
 	std::fill(FileAllocationTable.begin(), FileAllocationTable.end(), -1);
+
+	//Pusty dysk to jeden wolny obszar
+	freeExtents[0] = bitVector.size();
+	freeExtentLengths.insert(bitVector.size());
+	freeExtentHistogram[(unsigned int)log2(bitVector.size())]++;
 }
 
 void FileManager::Disk::write(const unsigned int &begin, const unsigned int &end, const std::string &data) {
+	Account(begin, end);
 	//Indeks ktry bdzie suy do wskazywania na komrki pamici
 	unsigned int index = begin;
 	//Iterowanie po danych typu string i zapisywanie znakw na dysku
 	for (unsigned int i = 0; i < data.size() && i <= end - begin; i++) {
-		space[index] = data[i];
+		at(index) = data[i];
 		index++;
 	}
 	//Zapisywanie NULL, jeli dane nie wypeniy ostatniego bloku
 	for (; index <= end; index++) {
-		space[index] = NULL;
+		at(index) = NULL;
 	}
+	UpdateChecksums(begin, end);
 }
 
 void FileManager::Disk::write(const unsigned int &index, const unsigned int &data) {
+	Account(index, index);
 	//Zapisz liczb pod danym indeksem
-	space[index] = data;
+	at(index) = data;
+	UpdateChecksums(index, index);
+}
+
+void FileManager::Disk::write(const unsigned int &begin, const std::vector<WriteBuffer> &buffers) {
+	unsigned int index = begin;
+	for (const WriteBuffer &buffer : buffers) {
+		for (size_t i = 0; i < buffer.length; i++) { at(index++) = buffer.data[i]; }
+	}
+	if (index == begin) { return; }
+	Account(begin, index - 1);
+	UpdateChecksums(begin, index - 1);
+}
+
+const bool FileManager::Disk::read(const unsigned int &begin, const std::vector<ReadBuffer> &buffers) {
+	size_t length = 0;
+	for (const ReadBuffer &buffer : buffers) { length += buffer.length; }
+	if (length == 0) { return true; }
+	Account(begin, begin + length - 1);
+	//Uszkodzone dane nie trafiaj do buforw
+	if (!VerifyChecksums(begin, begin + length - 1)) { return false; }
+
+	unsigned int index = begin;
+	for (const ReadBuffer &buffer : buffers) {
+		for (size_t i = 0; i < buffer.length; i++) { buffer.data[i] = at(index++); }
+	}
+	return true;
 }
 
 template<typename T>
@@ -54,61 +99,336 @@ const T FileManager::Disk::read(const unsigned int &begin, const unsigned int &e
 
 	//Jeli typ danych to string
 	if (typeid(T) == typeid(std::string)) {
+		Account(begin, end);
+		//Uszkodzone dane nie s zwracane
+		if (!VerifyChecksums(begin, end)) { return data; }
 		//Odczytaj przestrze dyskow od indeksu begin do indeksu end
 		for (unsigned int index = begin; index <= end; index++) {
 			//Dodaj znak zapisany na dysku do danych
-			data += space[index];
+			data += at(index);
 		}
 	}
 
 	return data;
 }
 
+char& FileManager::Disk::at(const unsigned int &index) {
+	//Blok woluminu b ley na urzdzeniu b % n jako jego blok b / n
+	const unsigned int block = index / BLOCK_SIZE;
+	return devices[DeviceOf(block)].space[block / devices.size() * BLOCK_SIZE + index % BLOCK_SIZE];
+}
+
+const unsigned int FileManager::Disk::DeviceOf(const unsigned int &block) const {
+	return block % devices.size();
+}
+
+void FileManager::Disk::Stripe(const unsigned int &deviceCount) {
+	//Zawarto woluminu w kolejnoci blokw
+	std::string data;
+	for (unsigned int index = 0; !devices.empty() && index < DISK_CAPACITY; index++) { data += at(index); }
+
+	const unsigned int blockCount = DISK_CAPACITY / BLOCK_SIZE;
+	devices = std::vector<Device>(deviceCount);
+	for (unsigned int device = 0; device < deviceCount; device++) {
+		//Urzdzenie dostaje co n-ty blok woluminu, zaczynajc od bloku o swoim numerze
+		devices[device].space.resize((blockCount - device + deviceCount - 1) / deviceCount * BLOCK_SIZE, NULL);
+	}
+	for (unsigned int index = 0; index < data.size(); index++) { at(index) = data[index]; }
+	for (unsigned int block = 0; block < blockCount; block++) {
+		if (FAT.bitVector[block] == 0) { devices[DeviceOf(block)].freeSpace += BLOCK_SIZE; }
+	}
+}
+
+void FileManager::Disk::UpdateChecksums(const unsigned int &begin, const unsigned int &end) {
+	//Bajty bloku le na urzdzeniu obok siebie
+	for (unsigned int block = begin / BLOCK_SIZE; block <= end / BLOCK_SIZE; block++) {
+		FAT.checksums[block] = Checksum::Crc32c(&at(block * BLOCK_SIZE), BLOCK_SIZE);
+	}
+}
+
+const bool FileManager::Disk::VerifyChecksums(const unsigned int &begin, const unsigned int &end) {
+	bool valid = true;
+	for (unsigned int block = begin / BLOCK_SIZE; block <= end / BLOCK_SIZE; block++) {
+		if (Checksum::Crc32c(&at(block * BLOCK_SIZE), BLOCK_SIZE) != FAT.checksums[block]) {
+			checksumErrors++;
+			std::cout << "Bd sumy kontrolnej bloku " << block << " - dane s uszkodzone!\n";
+			valid = false;
+		}
+	}
+	return valid;
+}
+
+const std::vector<unsigned int> FileManager::Disk::Scrub() {
+	Account(0, DISK_CAPACITY - 1);
+	std::vector<unsigned int> corruptBlocks;
+	for (unsigned int device = 0; device < devices.size(); device++) {
+		//Blok k urzdzenia to blok woluminu k * n + numer urzdzenia
+		const unsigned int blockCount = devices[device].space.size() / BLOCK_SIZE;
+		std::vector<unsigned int> checksums(blockCount);
+		Checksum::Crc32cBlocks(devices[device].space.data(), BLOCK_SIZE, blockCount, checksums.data());
+		for (unsigned int k = 0; k < blockCount; k++) {
+			const unsigned int block = k * devices.size() + device;
+			if (checksums[k] != FAT.checksums[block]) { corruptBlocks.push_back(block); }
+		}
+	}
+	checksumErrors += corruptBlocks.size();
+	std::sort(corruptBlocks.begin(), corruptBlocks.end());
+	return corruptBlocks;
+}
+
+void FileManager::Disk::Account(const unsigned int &begin, const unsigned int &end) {
+	//Liczba blokw przypadajcych na kade urzdzenie
+	std::vector<unsigned int> blocks(devices.size(), 0);
+	for (unsigned int block = begin / BLOCK_SIZE; block <= end / BLOCK_SIZE; block++) { blocks[DeviceOf(block)]++; }
+
+	//Najdusza cz operacji
+	unsigned long long slowest = 0;
+	for (unsigned int device = 0; device < devices.size(); device++) {
+		if (blocks[device] == 0) { continue; }
+		const unsigned long long time = DEVICE_ACCESS_COST + blocks[device] * DEVICE_TRANSFER_COST;
+		devices[device].requests++;
+		devices[device].blocks += blocks[device];
+		devices[device].busyTime += time;
+		slowest = std::max(slowest, time);
+	}
+	elapsedTime += slowest;
+}
+
+//-------------------- Strategie alokacji -------------------
+
+const std::vector<unsigned int> FileManager::FirstFitPolicy::FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) {
+	//Lista indeksw blokw obecnie sprawdzanego obszaru
+	std::vector<unsigned int> blockList;
+
+	for (unsigned int i = 0; i < bitVector.size(); i++) {
+		scanCost++;
+		//Jeli blok wolny, dodaj go do obszaru
+		if (bitVector[i] == 0) {
+			blockList.push_back(i);
+			//Pierwszy obszar o wystarczajcej dugoci jest wybierany
+			if (blockList.size() == blockCount) { return blockList; }
+		}
+		//Jeli blok zajty, obszar si koczy
+		else { blockList.clear(); }
+	}
+	return std::vector<unsigned int>();
+}
+
+const std::vector<unsigned int> FileManager::NextFitPolicy::FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) {
+	//Lista indeksw blokw obecnie sprawdzanego obszaru
+	std::vector<unsigned int> blockList;
+
+	//Przeglda dysk od miejsca ostatniej alokacji, zawijajc na pocztek dysku
+	for (unsigned int step = 0; step < bitVector.size() + blockCount; step++) {
+		const unsigned int i = (lastPosition + step) % bitVector.size();
+		//Obszar nie moe przechodzi przez koniec dysku
+		if (i == 0) { blockList.clear(); }
+
+		scanCost++;
+		if (bitVector[i] == 0) {
+			blockList.push_back(i);
+			if (blockList.size() == blockCount) {
+				//Kolejne szukanie rozpocznie si za przydzielonym obszarem
+				lastPosition = (i + 1) % bitVector.size();
+				return blockList;
+			}
+		}
+		else { blockList.clear(); }
+	}
+	return std::vector<unsigned int>();
+}
+
+const std::vector<unsigned int> FileManager::BestFitPolicy::FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) {
+	//Lista indeksw blokw (dopasowanie)
+	std::vector<unsigned int> blockList;
+	//Najlepsze dopasowanie
+	std::vector<unsigned int> bestBlockList(bitVector.size() + 1);
+
+	//Szukanie wolnych blokw speniajcych minimum miejsca
+	for (unsigned int i = 0; i < bitVector.size(); i++) {
+		scanCost++;
+		//Jeli blok wolny
+		if (bitVector[i] == 0) {
+			//Dodaj indeks bloku do listy blokw
+			blockList.push_back(i);
+		}
+		//Jeli blok zajty
+		else {
+			//Jeli uzyskana lista blokw jest wiksza od iloci blokw jak chcemy uzyska
+			//to dodaj uzyskane dopasowanie do listy dopasowa;
+			if (blockList.size() >= blockCount) {
+				//Jeli znalezione dopasowanie mniejsze ni najlepsze dopasowanie
+				if (blockList.size() < bestBlockList.size()) {
+					//Przypisanie nowego najlepszego dopasowania
+					bestBlockList = blockList;
+				}
+			}
+
+			//Czyci list blokw, aby mona przygotowa kolejne dopasowanie
+			blockList.clear();
+		}
+	}
+
+	/*
+	Jeli zdarzy si, e ostatni blok w wektorze bitowym jest wolny, to
+	ostatnie dopasownie nie zostanie dodane do listy dopasowa, dlatego
+	trzeba wykona poniszy kod. Jeli ostatni blok w wektorze bitowym
+	bdzie zajty to blockList bdzie pusty i nie spieni warunku
+	*/
+	if (blockList.size() >= blockCount) {
+		//Jeli blok wolny
+		if (blockList.size() < bestBlockList.size()) {
+			//Dodaj indeks bloku do listy blokw
+			bestBlockList = blockList;
+		}
+	}
+
+	//Jeli znalezione najlepsze dopasowanie
+	if (bestBlockList.size() < bitVector.size() + 1) {
+		//Odetnij nadmiarowe indeksy z dopasowania (jeli wiksze ni potrzeba)
+		bestBlockList.resize(blockCount);
+	}
+	//Inaczej zmniejsz dopasowanie do 0, eby po zwrceniu wybrano inn metod
+	else { bestBlockList.resize(0); }
+
+	return bestBlockList;
+}
+
+const std::vector<unsigned int> FileManager::WorstFitPolicy::FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) {
+	//Lista indeksw blokw obecnie sprawdzanego obszaru
+	std::vector<unsigned int> blockList;
+	//Najwikszy znaleziony obszar
+	std::vector<unsigned int> worstBlockList;
+
+	for (unsigned int i = 0; i < bitVector.size(); i++) {
+		scanCost++;
+		if (bitVector[i] == 0) { blockList.push_back(i); }
+		if (bitVector[i] == 1 || i == bitVector.size() - 1) {
+			//Zapamitaj obszar, jeli jest najwikszy z dotychczas znalezionych
+			if (blockList.size() > worstBlockList.size()) { worstBlockList = blockList; }
+			blockList.clear();
+		}
+	}
+
+	//Jeli nawet najwikszy obszar jest za may, zwr pusty wektor
+	if (worstBlockList.size() < blockCount) { return std::vector<unsigned int>(); }
+	//Wykorzystaj pocztek najwikszego obszaru
+	worstBlockList.resize(blockCount);
+	return worstBlockList;
+}
+
+const std::vector<unsigned int> FileManager::AlignedFitPolicy::FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) {
+	//Rozmiar obszaru - najmniejsza potga dwjki mieszczca danie
+	unsigned int alignedSize = 1;
+	while (alignedSize < blockCount) { alignedSize *= 2; }
+
+	//Sprawdzane s tylko obszary wyrwnane do swojego rozmiaru
+	for (unsigned int begin = 0; begin + alignedSize <= bitVector.size(); begin += alignedSize) {
+		bool free = true;
+		for (unsigned int i = begin; i < begin + alignedSize; i++) {
+			scanCost++;
+			//Zajty blok dyskwalifikuje cay obszar
+			if (bitVector[i] == 1) { free = false; break; }
+		}
+
+		if (free) {
+			//Zajmowane s tylko potrzebne bloki, reszta obszaru pozostaje wolna
+			std::vector<unsigned int> blockList;
+			for (unsigned int i = begin; i < begin + blockCount; i++) { blockList.push_back(i); }
+			return blockList;
+		}
+	}
+	return std::vector<unsigned int>();
+}
+
 //----------------------- FileManager  ----------------------
 
 FileManager::FileManager() {
 	//Przypisanie katalogu gwnego do obecnego katalogu 
 	currentDirectory = &DISK.FAT.rootDirectory;
+	//Domylnie pliki umieszczane s metod best-fit
+	allocationPolicy = std::unique_ptr<AllocationPolicy>(new BestFitPolicy());
 }
 
 //-------------------- Podstawowe Metody --------------------
 
 void FileManager::FileCreate(const std::string &name, const std::string &data) {
-	//Rozmiar pliku obliczony na podstawie podanych danych
-	const unsigned int fileSize = CalculateNeededBlocks(data)*BLOCK_SIZE;
+	FileCreateVectored(name, { WriteBuffer{ data.data(), data.size() } });
+}
+
+void FileManager::FileCreateVectored(const std::string &name, const std::vector<WriteBuffer> &buffers) {
+	//Pooenie pocztku kadego bufora w danych pliku
+	const std::vector<size_t> starts = BufferStarts(buffers);
+	const size_t dataSize = starts.back();
+	//Czy dane zmieszcz si we wpisie katalogu
+	const bool inlined = dataSize <= MAX_INLINE_SIZE;
+	//Liczba blokw do zaalokowania (bloki wypenione zerami staj si dziurami), may plik nie potrzebuje blokw
+	unsigned int allocatedBlocks = 0;
+	for (size_t begin = 0; !inlined && begin < dataSize; begin += BLOCK_SIZE) {
+		if (!CheckIfBuffersEmpty(SliceBuffers(buffers, starts, begin, std::min((size_t)BLOCK_SIZE, dataSize - begin)))) { allocatedBlocks++; }
+	}
+	//Rozmiar jaki plik zajmie na dysku
+	const unsigned int allocatedSize = allocatedBlocks * BLOCK_SIZE;
 
 	if (currentDirectory->files.size() + currentDirectory->subDirectories.size() < MAX_DIRECTORY_ELEMENTS) {
 		//Jeli plik si zmieci i nazwa nie uyta
-		if (CheckIfEnoughSpace(fileSize) && CheckIfNameUnused(*currentDirectory, name)) {
+		if (CheckIfEnoughSpace(allocatedSize) && CheckIfNameUnused(*currentDirectory, name)) {
 			//Jeli cieka nie przekracza maksymalnej dugoci
 			if (name.size() + GetCurrentPathLength() < MAX_PATH_LENGTH) {
-				//Stwrz plik o podanej nazwie
+				//Stwrz plik o podanej nazwie (rozmiar w blokach ustala zapis danych)
 				File file = File(name);
-				//Zapisz w pliku jego rozmiar
-				file.size = fileSize;
+				file.size = 0;
 				//Zapisz w plik jego rzeczywisty rozmiar
-				file.sizeOnDisk = data.size();
+				file.sizeOnDisk = dataSize;
 
 				//Zapisywanie daty stworzenia pliku
 				file.creationTime = GetCurrentTimeAndDate();
 				file.modificationTime = file.creationTime;
 
-				//Lista indeksw blokw, ktre zostan zaalokowane na potrzeby pliku
-				const std::vector<unsigned int> blocks = FindUnallocatedBlocks(file.size / BLOCK_SIZE);
+				//Dodanie pliku do statystyk fragmentacji
+				ChangeFileStatistics(file, true);
+
+				//May plik trafia w caoci do wpisu katalogu, bez udziau alokatora i dysku
+				if (inlined) {
+					file.inlined = true;
+					CopyBuffers(file.inlineData, 0, buffers);
+					file.FATindex = -1;
+					currentDirectory->files[file.name] = file;
+					NameIndexAdd(file.name, GetCurrentPath() + '/' + file.name);
 
-				//Wpisanie blokw do tablicy FAT
-				for (unsigned int i = 0; i < blocks.size() - 1; i++) {
-					DISK.FAT.FileAllocationTable[blocks[i]] = blocks[i + 1];
+					if (messages) { std::cout << "Stworzono plik o nazwie '" << file.name << "' w ciece '" << GetCurrentPath() << "'.\n"; }
+					return;
 				}
 
-				//Dodanie do pliku indeksu pierwszego bloku na ktrym jest zapisany
-				file.FATindex = blocks[0];
+				//Przy opnionej alokacji dane czekaj w buforze, a bloki wybierane s przy jego oprnieniu
+				if (delayedAllocation) {
+					file.delayed = true;
+					CopyBuffers(file.buffer, 0, buffers);
+					file.FATindex = -1;
+					DISK.FAT.delayedSpace += allocatedSize;
+					currentDirectory->files[file.name] = file;
+					NameIndexAdd(file.name, GetCurrentPath() + '/' + file.name);
+
+					if (messages) { std::cout << "Stworzono plik o nazwie '" << file.name << "' w ciece '" << GetCurrentPath() << "'.\n"; }
+					return;
+				}
 
-				//Dodanie pliku do obecnego katalogu
+				//Dodanie pustego pliku do obecnego katalogu
+				file.sizeOnDisk = 0;
+				file.FATindex = -1;
 				currentDirectory->files[file.name] = file;
-
-				//Zapisanie danych pliku na dysku
-				WriteFile(file, data);
+				NameIndexAdd(file.name, GetCurrentPath() + '/' + file.name);
+
+				//Zapisanie danych pliku na dysku - wszystkie bloki alokowane s jednym wyszukaniem
+				if (!WriteBlocks(currentDirectory->files[file.name], 0, buffers)) {
+					//Nieudany zapis nie zostawia pustego pliku
+					ChangeFileStatistics(currentDirectory->files[file.name], false);
+					currentDirectory->files.erase(file.name);
+					NameIndexRemove(file.name, GetCurrentPath() + '/' + file.name);
+					std::cout << "Nie stworzono pliku o nazwie '" << file.name << "'!\n";
+					return;
+				}
+				currentDirectory->files[file.name].modificationTime = file.creationTime;
 
 				if (messages) { std::cout << "Stworzono plik o nazwie '" << file.name << "' w ciece '" << GetCurrentPath() << "'.\n"; }
 				return;
@@ -116,7 +436,7 @@ void FileManager::FileCreate(const std::string &name, const std::string &data) {
 			else { std::cout << "cieka za duga!\n"; }
 		}
 		//Jeli plik si nie mieci
-		if (!CheckIfEnoughSpace(fileSize)) {
+		if (!CheckIfEnoughSpace(allocatedSize)) {
 			std::cout << "Za mao miejsca!\n";
 		}
 		//Jeli nazwa uyta
@@ -129,33 +449,338 @@ void FileManager::FileCreate(const std::string &name, const std::string &data) {
 	}
 }
 
-//!!!!!!!!!! NIEDOKOCZONE !!!!!!!!!!
-const std::string FileManager::FileOpen(const std::string &name) {
-	return DISK.read<std::string>(0 * 8, 4 * 8 - 1);
+const bool FileManager::FileOpen(const std::string &name) {
+	if (currentDirectory->files.find(name) == currentDirectory->files.end()) {
+		std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n";
+		return false;
+	}
+	const std::string path = GetCurrentPath() + '/' + name;
+	if (openFiles.find(path) != openFiles.end()) {
+		std::cout << "Plik '" << path << "' jest ju otwarty!\n";
+		return false;
+	}
+	openFiles[path] = OpenFile();
+
+	if (messages) { std::cout << "Otwarto plik '" << path << "'.\n"; }
+	return true;
 }
-//!!!!!!!!!! NIEDOKOCZONE !!!!!!!!!!
 
-const std::string FileManager::FileGetData(const File &file) {
-	//Dane
+const std::string FileManager::FileRead(const std::string &name, const unsigned int &length) {
+	const std::string path = GetCurrentPath() + '/' + name;
+	auto openIterator = openFiles.find(path);
+	if (openIterator == openFiles.end()) {
+		std::cout << "Plik '" << path << "' nie jest otwarty!\n";
+		return "";
+	}
+	OpenFile &openFile = openIterator->second;
+	const File &file = currentDirectory->files.at(name);
+
+	if (openFile.position >= file.sizeOnDisk || length == 0) { return ""; }
+	const unsigned int end = std::min((unsigned int)file.sizeOnDisk, openFile.position + length);
+	if (file.inlined || file.delayed) {
+		const std::string data = (file.inlined ? file.inlineData : file.buffer).substr(openFile.position, end - openFile.position);
+		openFile.position = end;
+		return data;
+	}
+
+	//Bloki logiczne objte odczytem
+	const unsigned int firstBlock = openFile.position / BLOCK_SIZE;
+	const unsigned int lastBlock = (end - 1) / BLOCK_SIZE;
+	const unsigned int blockCount = file.size / BLOCK_SIZE;
+	readAheadStatistics.requestedBlocks += lastBlock - firstBlock + 1;
+
+	//Bloki ju minite nie bd potrzebne
+	while (!openFile.readAhead.empty() && openFile.readAhead.begin()->first < firstBlock) {
+		openFile.readAhead.erase(openFile.readAhead.begin());
+	}
+
 	std::string data;
-	//Indeks do wczytywania danych z dysku
-	unsigned int index = file.FATindex;
-	//Dopki nie natrafimy na koniec pliku
-	while (index != -1) {
-		//Dodaje do danych fragment pliku pod wskazanym indeksem
-		data += DISK.read<std::string>(index*BLOCK_SIZE, (index + 1)*BLOCK_SIZE - 1);
-		//Przypisuje indeksowi kolejny indeks w tablicy FAT
-		index = DISK.FAT.FileAllocationTable[index];
+	bool hit = false;
+	for (unsigned int i = firstBlock; i <= lastBlock; ) {
+		auto cached = openFile.readAhead.find(i);
+		if (cached != openFile.readAhead.end()) {
+			data += cached->second;
+			readAheadStatistics.readAheadHits++;
+			hit = true;
+			i++;
+			continue;
+		}
+		//Cig brakujcych blokw odczytywany na danie
+		unsigned int missingEnd = i + 1;
+		while (missingEnd <= lastBlock && openFile.readAhead.find(missingEnd) == openFile.readAhead.end()) { missingEnd++; }
+		const std::vector<std::string> fragments = ReadOpenFileBlocks(file, openFile, i, missingEnd - i);
+		//Uszkodzone bloki - nic nie jest zwracane, a pozycja si nie zmienia
+		if (fragments.empty()) {
+			std::cout << "Plik '" << path << "' zawiera uszkodzone bloki - dane nie zostay odczytane!\n";
+			return "";
+		}
+		for (const std::string &fragment : fragments) { data += fragment; }
+		i = missingEnd;
+	}
+	//Ostatni blok moe zawiera dane nastpnego odczytu
+	while (!openFile.readAhead.empty() && openFile.readAhead.begin()->first < lastBlock) {
+		openFile.readAhead.erase(openFile.readAhead.begin());
+	}
+
+	//Odczyt z wyprzedzeniem - okno ronie, dopki odczyty trafiaj w odczytane wczeniej bloki
+	if (openFile.window > 0) {
+		if (hit) { openFile.window = std::min(openFile.window * 2, (unsigned int)MAX_READ_AHEAD); }
+		unsigned int next = lastBlock + 1;
+		while (next < blockCount && openFile.readAhead.find(next) != openFile.readAhead.end()) { next++; }
+		const unsigned int stop = std::min(blockCount, lastBlock + 1 + openFile.window);
+		if (next < stop) {
+			const std::vector<std::string> fragments = ReadOpenFileBlocks(file, openFile, next, stop - next);
+			for (unsigned int i = 0; i < fragments.size(); i++) { openFile.readAhead[next + i] = fragments[i]; }
+			readAheadStatistics.readAheadBlocks += fragments.size();
+		}
+	}
+	//Dostp losowy zakoczony - nastpny odczyt zaczyna wyprzedzanie od nowa
+	else { openFile.window = 1; }
+
+	const unsigned int start = openFile.position;
+	openFile.position = end;
+	return data.substr(start - firstBlock * BLOCK_SIZE, end - start);
+}
+
+void FileManager::FileSeek(const std::string &name, const unsigned int &position) {
+	const std::string path = GetCurrentPath() + '/' + name;
+	auto openIterator = openFiles.find(path);
+	if (openIterator == openFiles.end()) {
+		std::cout << "Plik '" << path << "' nie jest otwarty!\n";
+		return;
+	}
+	OpenFile &openFile = openIterator->second;
+	if (position == openFile.position) { return; }
+
+	//Dostp losowy - bloki odczytane z wyprzedzeniem s odrzucane, a wyprzedzanie wstrzymywane
+	readAheadStatistics.wastedBlocks += openFile.readAhead.size();
+	openFile.readAhead.clear();
+	openFile.window = 0;
+	openFile.position = position;
+}
+
+void FileManager::FileClose(const std::string &name) {
+	const std::string path = GetCurrentPath() + '/' + name;
+	auto openIterator = openFiles.find(path);
+	if (openIterator == openFiles.end()) {
+		std::cout << "Plik '" << path << "' nie jest otwarty!\n";
+		return;
+	}
+	readAheadStatistics.wastedBlocks += openIterator->second.readAhead.size();
+	openFiles.erase(openIterator);
+	//Buforowane dane trafiaj na dysk, a niewykorzystana rezerwacja wraca do wolnego miejsca
+	auto fileIterator = currentDirectory->files.find(name);
+	if (fileIterator != currentDirectory->files.end()) {
+		if (fileIterator->second.delayed) { FileFlush(name); }
+		ReleaseReservation(fileIterator->second);
+	}
+
+	if (messages) { std::cout << "Zamknito plik '" << path << "'.\n"; }
+}
+
+void FileManager::FileReserve(const std::string &name, const unsigned int &size) {
+	auto fileIterator = currentDirectory->files.find(name);
+	if (fileIterator == currentDirectory->files.end()) {
+		std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n";
+		return;
+	}
+	if (fileIterator->second.swap) {
+		std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+		return;
+	}
+	File &file = fileIterator->second;
+
+	//Liczba blokw logicznych pliku (plik we wpisie katalogu nie zajmuje blokw)
+	const unsigned int fileBlocks = file.inlined ? 0 : file.size / BLOCK_SIZE;
+	const unsigned int neededBlocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	if (neededBlocks <= fileBlocks + file.reserved.size()) {
+		std::cout << "Podano niepoprawny rozmiar!\n";
+		return;
+	}
+	const unsigned int blockCount = neededBlocks - fileBlocks - file.reserved.size();
+
+	//Ostatni blok pliku lub rezerwacji, za ktrym najlepiej umieci now rezerwacj
+	unsigned int last = -1;
+	if (!file.reserved.empty()) { last = file.reserved.back(); }
+	else if (!file.inlined) {
+		for (const unsigned int &block : GetFileBlocks(file)) { if (block != -1) { last = block; } }
+	}
+	std::vector<unsigned int> blocks;
+	if (last != -1 && last + blockCount < DISK.FAT.bitVector.size()) {
+		for (unsigned int block = last + 1; block <= last + blockCount && DISK.FAT.bitVector[block] == 0; block++) { blocks.push_back(block); }
+		if (blocks.size() < blockCount) { blocks.clear(); }
+	}
+	//W przeciwnym razie najlepiej pasujcy cigy obszar
+	if (blocks.empty()) { blocks = FindContiguousBlocks(blockCount); }
+	if (blocks.empty()) {
+		std::cout << "Brak cigego obszaru " << blockCount << " blokw na rezerwacj!\n";
+		return;
+	}
+
+	//Zarezerwowane bloki s zajte, ale nie nale jeszcze do acucha pliku
+	for (const unsigned int &block : blocks) {
+		ChangeBitVectorValue(block, 1);
+		file.reserved.push_back(block);
+	}
+	DISK.FAT.reservedSpace += blockCount * BLOCK_SIZE;
+
+	if (messages) { std::cout << "Zarezerwowano " << blockCount * BLOCK_SIZE << " Bajtw dla pliku '" << name << "'.\n"; }
+}
+
+void FileManager::FileReleaseReservation(const std::string &name) {
+	auto fileIterator = currentDirectory->files.find(name);
+	if (fileIterator == currentDirectory->files.end()) {
+		std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n";
+		return;
+	}
+	const unsigned int released = fileIterator->second.reserved.size() * BLOCK_SIZE;
+	ReleaseReservation(fileIterator->second);
+
+	if (messages) { std::cout << "Zwolniono " << released << " Bajtw rezerwacji pliku '" << name << "'.\n"; }
+}
+
+const bool FileManager::FileFlush(const std::string &name) {
+	auto fileIterator = currentDirectory->files.find(name);
+	if (fileIterator == currentDirectory->files.end()) {
+		std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n";
+		return false;
+	}
+	File &file = fileIterator->second;
+	if (!file.delayed) { return true; }
+
+	//Plik staje si pustym plikiem dyskowym, a cay bufor zapisywany jest jednym zapisem
+	const unsigned int bufferedSpace = CountDataBlocks(file.buffer) * BLOCK_SIZE;
+	const tm modificationTime = file.modificationTime;
+	//Miejsce obiecane buforowi jest zwalniane na czas zapisu, inaczej zapis nie zmieciby si w nim
+	DISK.FAT.delayedSpace -= bufferedSpace;
+	file.delayed = false;
+	file.sizeOnDisk = 0;
+	if (!WriteBlocks(file, 0, { WriteBuffer{ file.buffer.data(), file.buffer.size() } })) {
+		//Bufor zostaje, wic dane nie gin - mona sprbowa ponownie po zwolnieniu miejsca
+		DISK.FAT.delayedSpace += bufferedSpace;
+		file.delayed = true;
+		file.sizeOnDisk = file.buffer.size();
+		std::cout << "Nie udao si zapisa buforowanych danych pliku '" << name << "', pozostaj w buforze!\n";
+		return false;
+	}
+	file.buffer.clear();
+	OpenFileInvalidate(GetCurrentPath() + '/' + name);
+	//Oprnienie bufora nie jest modyfikacj pliku
+	file.modificationTime = modificationTime;
+	return true;
+}
+
+const std::string FileManager::FileGetData(const File &file) {
+	//Dane maego pliku znajduj si we wpisie katalogu
+	if (file.inlined) { return file.inlineData; }
+	//Dane pliku z opnion alokacj znajduj si w buforze
+	if (file.delayed) { return file.buffer; }
+
+	//Przechodzi po kolejnych blokach logicznych pliku
+	const std::vector<unsigned int> blocks = GetFileBlocks(file);
+	const std::string data = ReadBlocks(blocks);
+	if (!blocks.empty() && data.empty()) {
+		std::cout << "Plik '" << file.name << "' zawiera uszkodzone bloki - dane nie zostay odczytane!\n";
 	}
 	return data;
 }
 
+void FileManager::FileWrite(const std::string &name, const unsigned int &offset, const std::string &data) {
+	FileWriteVectored(name, offset, { WriteBuffer{ data.data(), data.size() } });
+}
+
+void FileManager::FileWriteVectored(const std::string &name, const unsigned int &offset, const std::vector<WriteBuffer> &buffers) {
+	//Iterator zwracany podczas przeszukiwania obecnego katalogu za plikiem o podanej nazwie
+	auto fileIterator = currentDirectory->files.find(name);
+
+	//Jeli znaleziono plik
+	if (fileIterator != currentDirectory->files.end()) {
+		if (fileIterator->second.swap) {
+			std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+			return;
+		}
+		File &file = fileIterator->second;
+		//Liczba zapisywanych bajtw
+		const unsigned int dataSize = BufferStarts(buffers).back();
+
+		//Plik z opnion alokacj zmienia tylko bufor, miejsce na dysku jest jedynie odliczane
+		if (file.delayed) {
+			std::string content = file.buffer;
+			CopyBuffers(content, offset, buffers);
+
+			const unsigned int oldBlocks = CountDataBlocks(file.buffer);
+			const unsigned int newBlocks = CountDataBlocks(content);
+			if (newBlocks > oldBlocks && !CheckIfEnoughSpace((newBlocks - oldBlocks)*BLOCK_SIZE)) {
+				std::cout << "Za mao miejsca!\n";
+				return;
+			}
+			DISK.FAT.delayedSpace = DISK.FAT.delayedSpace + newBlocks * BLOCK_SIZE - oldBlocks * BLOCK_SIZE;
+
+			file.buffer = content;
+			file.sizeOnDisk = content.size();
+			file.modificationTime = GetCurrentTimeAndDate();
+			OpenFileInvalidate(GetCurrentPath() + '/' + name);
+			if (messages) { std::cout << "Zapisano " << dataSize << " Bajtw w pliku '" << name << "' od pozycji " << offset << ".\n"; }
+			return;
+		}
+
+		if (file.inlined) {
+			//Nowa zawarto pliku
+			std::string content = file.inlineData;
+			CopyBuffers(content, offset, buffers);
+
+			//Jeli plik nadal jest may, zostaje we wpisie katalogu
+			if (content.size() <= MAX_INLINE_SIZE) {
+				file.inlineData = content;
+				file.sizeOnDisk = content.size();
+				file.modificationTime = GetCurrentTimeAndDate();
+				OpenFileInvalidate(GetCurrentPath() + '/' + name);
+				if (messages) { std::cout << "Zapisano " << dataSize << " Bajtw w pliku '" << name << "' od pozycji " << offset << ".\n"; }
+				return;
+			}
+
+			//Liczba blokw potrzebnych po przeniesieniu pliku na dysk
+			unsigned int neededBlocks = CountDataBlocks(content);
+			//Rezerwacja pliku pokrywa cz potrzebnych blokw
+			neededBlocks -= std::min(neededBlocks, (unsigned int)file.reserved.size());
+			if (!CheckIfEnoughSpace(neededBlocks*BLOCK_SIZE)) {
+				std::cout << "Za mao miejsca!\n";
+				return;
+			}
+
+			//Przeniesienie pliku do blokw (lub do bufora) - od teraz plik zachowuje si jak pusty plik dyskowy
+			file.inlined = false;
+			file.inlineData.clear();
+			file.delayed = delayedAllocation;
+			file.size = 0;
+			file.sizeOnDisk = 0;
+			FileWrite(name, 0, content);
+			return;
+		}
+
+		if (!WriteBlocks(file, offset, buffers)) { return; }
+		//Odczytane z wyprzedzeniem bloki i pozycja w acuchu s nieaktualne
+		OpenFileInvalidate(GetCurrentPath() + '/' + name);
+
+		if (messages) { std::cout << "Zapisano " << dataSize << " Bajtw w pliku '" << name << "' od pozycji " << offset << ".\n"; }
+	}
+	else { std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n"; }
+}
+
 void FileManager::FileDelete(const std::string &name) {
 	//Iterator zwracany podczas przeszukiwania obecnego katalogu za plikiem o podanej nazwie
 	auto fileIterator = currentDirectory->files.find(name);
 
 	//Jeli znaleziono plik
 	if (fileIterator != currentDirectory->files.end()) {
+		if (fileIterator->second.swap) {
+			std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+			return;
+		}
+		//Zwolnienie rezerwacji pliku
+		ReleaseReservation(fileIterator->second);
+		//Buforowane dane s po prostu odrzucane, bez udziau dysku
+		if (fileIterator->second.delayed) { DISK.FAT.delayedSpace -= CountDataBlocks(fileIterator->second.buffer) * BLOCK_SIZE; }
 		//Zmienna do tymczasowego przechowywania kolejnego indeksu
 		unsigned int tempIndex;
 		//Obecny indeks
@@ -165,14 +790,19 @@ void FileManager::FileDelete(const std::string &name) {
 			//Spisz kolejny indeks
 			tempIndex = DISK.FAT.FileAllocationTable[index];
 			//Oznacz obecny indeks jako wolny
-			DISK.FAT.bitVector[index] = 0;
+			ChangeBitVectorValue(index, 0);
 			//Obecny indeks w tablicy FAT wskazuje na nic
 			DISK.FAT.FileAllocationTable[index] = -1;
 			//Przypisz do obecnego indeksu kolejny indeks
 			index = tempIndex;
 		}
+		//Usunicie pliku ze statystyk fragmentacji
+		ChangeFileStatistics(fileIterator->second, false);
 		//Usu plik z obecnego katalogu
 		currentDirectory->files.erase(fileIterator);
+		NameIndexRemove(name, GetCurrentPath() + '/' + name);
+		//Usunity plik przestaje by otwarty
+		openFiles.erase(GetCurrentPath() + '/' + name);
 
 		if (messages) { std::cout << "Usunito plik o nazwie '" << name << "' znajdujcy si w ciece '" + GetCurrentPath() + "'.\n"; }
 	}
@@ -184,36 +814,50 @@ void FileManager::FileTruncate(const std::string &name, const unsigned int &size
 	auto fileIterator = currentDirectory->files.find(name);
 	//Jeli znaleziono plik
 	if (fileIterator != currentDirectory->files.end()) {
-		if (size <= fileIterator->second.size - BLOCK_SIZE) {
-			unsigned int sizeToStart = (unsigned int)ceil((double)size / (double)BLOCK_SIZE)*BLOCK_SIZE;
-			//Zmienna do tymczasowego przechowywania kolejnego indeksu
-			unsigned int tempIndex;
-			//Zmienna do analizowania, ju mona usuwa cz pliku
-			unsigned int currentSize = 0;
-			//Obecny indeks
-			unsigned index = fileIterator->second.FATindex;
-			//Dopki indeks na co wskazuje
-			while (index != -1) {
-				//Zwiksz obecny rozmiar o rozmiar jednostki alokacji
-				currentSize += BLOCK_SIZE;
-				//Spisz kolejny indeks
-				tempIndex = DISK.FAT.FileAllocationTable[index];
-
-				//Jeli obecny rozmiar przewysza rozmiar potrzebny do rozpoczcia usuwania
-				//zacznij usuwa bloki
-				if (currentSize > sizeToStart) {
-					//Zmniejszenie rozmiaru pliku
-					fileIterator->second.size -= BLOCK_SIZE;
-					//Po uciciu rozmiar i rozmiar rzeczywisty bd takie same
-					fileIterator->second.sizeOnDisk = fileIterator->second.size;
-					//Oznacz obecny indeks jako wolny
-					DISK.FAT.bitVector[index] = 0;
-					//Obecny indeks w tablicy FAT wskazuje na nic
-					DISK.FAT.FileAllocationTable[index] = -1;
+		if (fileIterator->second.swap) {
+			std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+			return;
+		}
+		//Plik przechowywany we wpisie katalogu lub w buforze jest po prostu skracany
+		if (fileIterator->second.inlined || fileIterator->second.delayed) {
+			std::string &content = fileIterator->second.inlined ? fileIterator->second.inlineData : fileIterator->second.buffer;
+			if (size < content.size()) {
+				if (fileIterator->second.delayed) { DISK.FAT.delayedSpace -= CountDataBlocks(content) * BLOCK_SIZE; }
+				content.resize(size);
+				if (fileIterator->second.delayed) { DISK.FAT.delayedSpace += CountDataBlocks(content) * BLOCK_SIZE; }
+				fileIterator->second.sizeOnDisk = size;
+				OpenFileInvalidate(GetCurrentPath() + '/' + name);
+				if (messages) { std::cout << "Zmniejszono plik o nazwie '" << name << "' do rozmiaru " << size << " Bajtw.\n"; }
+			}
+			else { std::cout << "Podano niepoprawny rozmiar!\n"; }
+		}
+		//Plik musi zmale o co najmniej jeden blok (plik krtszy ni blok nie ma czego odda)
+		else if (fileIterator->second.size >= BLOCK_SIZE && size <= fileIterator->second.size - BLOCK_SIZE) {
+			//Liczba blokw logicznych, ktre pozostan w pliku
+			const unsigned int blocksToKeep = (unsigned int)ceil((double)size / (double)BLOCK_SIZE);
+			//Bloki pliku
+			std::vector<unsigned int> blocks = GetFileBlocks(fileIterator->second);
+
+			//Zwolnij bloki znajdujce si za nowym kocem pliku (dziury nie zajmuj blokw)
+			for (unsigned int i = blocksToKeep; i < blocks.size(); i++) {
+				if (blocks[i] != -1) {
+					//Oznacz blok jako wolny
+					ChangeBitVectorValue(blocks[i], 0);
+					//Blok w tablicy FAT wskazuje na nic
+					DISK.FAT.FileAllocationTable[blocks[i]] = -1;
 				}
-				//Przypisz do obecnego indeksu kolejny indeks
-				index = tempIndex;
 			}
+			//Tylko skrcenie - ewentualne nowe pozycje byyby dziurami, a nie blokiem 0
+			blocks.resize(blocksToKeep, -1);
+
+			//Zmniejszenie rozmiaru pliku
+			fileIterator->second.size = blocksToKeep * BLOCK_SIZE;
+			//Po uciciu rozmiar i rozmiar rzeczywisty bd takie same
+			fileIterator->second.sizeOnDisk = fileIterator->second.size;
+			//Zakoczenie acucha na ostatnim pozostawionym bloku
+			LinkFileBlocks(fileIterator->second, blocks);
+			OpenFileInvalidate(GetCurrentPath() + '/' + name);
+
 			if (messages) { std::cout << "Zmniejszono plik o nazwie '" << name << "' do rozmiaru " << fileIterator->second.size << " Bajtw.\n"; }
 		}
 		else { std::cout << "Podano niepoprawny rozmiar!\n"; }
@@ -229,8 +873,9 @@ void FileManager::DirectoryCreate(const std::string &name) {
 			if (name.size() + GetCurrentPathLength() < MAX_PATH_LENGTH) {
 				//Do podkatalogw obecnego katalogu dodaj nowy katalog o podanej nazwie
 				currentDirectory->subDirectories[name] = Directory(name, &(*currentDirectory));
+				NameIndexAdd(name, GetCurrentPath() + '/' + name);
 				//Zapisanie daty stworzenia katalogu
-				currentDirectory->creationTime = GetCurrentTimeAndDate();
+				currentDirectory->subDirectories[name].creationTime = GetCurrentTimeAndDate();
 				if (messages) {
 					std::cout << "Stworzono katalog o nazwie '" << currentDirectory->subDirectories[name].name
 						<< "' w ciece '" << GetCurrentPath() << "'.\n";
@@ -260,6 +905,8 @@ void FileManager::DirectoryDown(const std::string &name) {
 	if (currentDirectory->subDirectories.find(name) != currentDirectory->subDirectories.end()) {
 		//Przejcie do katalogu o wskazanej nazwie
 		currentDirectory = &(currentDirectory->subDirectories.find(name)->second);
+		//Wczytanie zawartoci katalogu przy pierwszym wejciu
+		LoadDirectory(*currentDirectory);
 		std::cout << "Obecna cieka to '" << GetCurrentPath() << "'.\n";
 	}
 	else { std::cout << "Brak katalogu o podanej nazwie!\n"; }
@@ -273,6 +920,10 @@ void FileManager::FileRename(const std::string &name, const std::string &changeN
 
 	//Jeli znaleziono plik
 	if (file != currentDirectory->files.end()) {
+		if (file->second.swap) {
+			std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+			return;
+		}
 		//Jeli plik si zmieci i nazwa nie uyta
 		if (CheckIfNameUnused(*currentDirectory, changeName)) {
 			if (changeName.size() + GetCurrentPathLength() < MAX_PATH_LENGTH) {
@@ -287,23 +938,644 @@ void FileManager::FileRename(const std::string &name, const std::string &changeN
 				currentDirectory->files[changeName] = file->second;
 				//Usunicie starego klucza
 				currentDirectory->files.erase(file);
+				NameIndexRemove(name, GetCurrentPath() + '/' + name);
+				NameIndexAdd(changeName, GetCurrentPath() + '/' + changeName);
+				//Otwarty plik pozostaje otwarty pod now nazw
+				auto openIterator = openFiles.find(GetCurrentPath() + '/' + name);
+				if (openIterator != openFiles.end()) {
+					openFiles[GetCurrentPath() + '/' + changeName] = openIterator->second;
+					openFiles.erase(openIterator);
+				}
+
+				if (messages) { std::cout << "Zmieniono nazw pliku '" << name << "' na '" << currentDirectory->files[changeName].name << "'.\n"; }
+				return;
+			}
+			else { std::cout << "cieka za duga!\n"; }
+		}
+		else {
+			std::cout << "Nazwa pliku '" << changeName << "' ju zajta!\n";
+		}
+	}
+	else { std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n"; }
+}
+
+void FileManager::FileMove(const std::string &name, const std::string &directoryPath) {
+	//Iterator zwracany podczas przeszukiwania obecnego katalogu za plikiem o podanej nazwie
+	auto fileIterator = currentDirectory->files.find(name);
+	if (fileIterator == currentDirectory->files.end()) {
+		std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n";
+		return;
+	}
+	if (fileIterator->second.swap) {
+		std::cout << "Plik wymiany '" << name << "' jest uywany przez zarzdc pamici!\n";
+		return;
+	}
+	Directory* target = FindDirectory(directoryPath);
+	if (target == nullptr) {
+		std::cout << "Brak katalogu o podanej nazwie!\n";
+		return;
+	}
+	if (target == currentDirectory) {
+		std::cout << "Plik '" << name << "' ju znajduje si w ciece '" << GetCurrentPath() << "'!\n";
+		return;
+	}
+	if (!CheckIfNameUnused(*target, name)) {
+		std::cout << "Nazwa pliku '" << name << "' ju zajta!\n";
+		return;
+	}
+	if (name.size() + GetDirectoryPathLength(target) >= MAX_PATH_LENGTH) {
+		std::cout << "cieka za duga!\n";
+		return;
+	}
+	if (target->files.size() + target->subDirectories.size() >= MAX_DIRECTORY_ELEMENTS) {
+		std::cout << "Osignito limit elementw w ciece '" << GetDirectoryPath(target) << "'!\n";
+		return;
+	}
+
+	const std::string oldPath = GetCurrentPath() + '/' + name;
+	const std::string newPath = GetDirectoryPath(target) + '/' + name;
+	//Przepicie wza tablicy hashowej - wpis pliku nie jest kopiowany
+	target->files.insert(currentDirectory->files.extract(fileIterator));
+	NameIndexRemove(name, oldPath);
+	NameIndexAdd(name, newPath);
+	//Otwarty plik pozostaje otwarty pod now ciek (razem z kursorem i buforem odczytu z wyprzedzeniem)
+	auto openIterator = openFiles.find(oldPath);
+	if (openIterator != openFiles.end()) {
+		auto openFile = openFiles.extract(openIterator);
+		openFile.key() = newPath;
+		openFiles.insert(std::move(openFile));
+	}
+
+	if (messages) { std::cout << "Przeniesiono plik '" << name << "' do cieki '" << GetDirectoryPath(target) << "'.\n"; }
+}
+
+void FileManager::DirectoryDelete(const std::string &name) {
+	auto directoryIterator = currentDirectory->subDirectories.find(name);
+	if (directoryIterator == currentDirectory->subDirectories.end()) {
+		std::cout << "Brak katalogu o podanej nazwie!\n";
+		return;
+	}
+	if (CheckIfContainsSwap(directoryIterator->second)) {
+		std::cout << "Katalog '" << name << "' zawiera plik wymiany uywany przez zarzdc pamici!\n";
+		return;
+	}
+
+	const std::string path = GetCurrentPath() + '/' + name;
+	//Bloki i cieki caego poddrzewa
+	std::vector<unsigned int> blocks;
+	std::vector<std::string> paths;
+	CollectDirectory(directoryIterator->second, path, blocks, paths);
+	//Wszystkie bloki zwalniane s razem
+	FreeBlocks(blocks);
+
+	NameIndexRemove(name, path);
+	for (const std::string &entry : paths) { NameIndexRemove(entry.substr(entry.rfind('/') + 1), entry); }
+	//Pliki poddrzewa przestaj by otwarte
+	openFiles.erase(openFiles.lower_bound(path + '/'), openFiles.lower_bound(path + char('/' + 1)));
+	currentDirectory->subDirectories.erase(directoryIterator);
+
+	if (messages) {
+		std::cout << "Usunito katalog o nazwie '" << name << "' znajdujcy si w ciece '" << GetCurrentPath()
+			<< "' (zwolniono " << blocks.size() * BLOCK_SIZE << " Bajtw).\n";
+	}
+}
+
+void FileManager::DirectoryRoot() {
+	while (currentDirectory->parentDirectory != NULL) {
+		DirectoryUp();
+	}
+}
+
+void FileManager::SetAllocationPolicy(const AllocationPolicyType &type) {
+	switch (type) {
+	case AllocationPolicyType::NextFit: allocationPolicy = std::unique_ptr<AllocationPolicy>(new NextFitPolicy()); break;
+	case AllocationPolicyType::FirstFit: allocationPolicy = std::unique_ptr<AllocationPolicy>(new FirstFitPolicy()); break;
+	case AllocationPolicyType::WorstFit: allocationPolicy = std::unique_ptr<AllocationPolicy>(new WorstFitPolicy()); break;
+	case AllocationPolicyType::BestFit: allocationPolicy = std::unique_ptr<AllocationPolicy>(new BestFitPolicy()); break;
+	case AllocationPolicyType::AlignedFit: allocationPolicy = std::unique_ptr<AllocationPolicy>(new AlignedFitPolicy()); break;
+	}
+	if (messages) { std::cout << "Ustawiono strategi alokacji '" << allocationPolicy->Name() << "'.\n"; }
+}
+
+void FileManager::SetDelayedAllocation(const bool &enabled) {
+	delayedAllocation = enabled;
+	//Bez opnionej alokacji aden plik nie moe czeka w buforze
+	if (!enabled && !DiskSync()) {
+		std::cout << "Opniona alokacja pozostaje wczona!\n";
+		delayedAllocation = true;
+		return;
+	}
+	if (messages) { std::cout << (enabled ? "Wczono" : "Wyczono") << " opnion alokacj.\n"; }
+}
+
+const bool FileManager::DiskSync() {
+	return FlushDirectory(DISK.FAT.rootDirectory);
+}
+
+void FileManager::VolumeSetDevices(const unsigned int &count) {
+	if (count == 0 || count > DISK.FAT.bitVector.size()) {
+		std::cout << "Niepoprawna liczba urzdze!\n";
+		return;
+	}
+	DISK.Stripe(count);
+	//Otwarte pliki mog dalej uywa swoich kursorw - zmienia si tylko pooenie blokw na urzdzeniach
+	if (messages) { std::cout << "Rozoono wolumin na " << count << " urzdze.\n"; }
+}
+
+void FileManager::DiskSave(const std::string &path) {
+	//Zapis wymaga penego drzewa katalogw, wic niewczytane katalogi s wczytywane
+	LoadAllDirectories(DISK.FAT.rootDirectory);
+	//Obraz zawiera tylko dane zapisane na dysku, wic dane, ktre zostay w buforach, zginyby
+	if (!DiskSync()) {
+		std::cout << "Nie zapisano obrazu dysku '" << path << "'!\n";
+		return;
+	}
+
+	const unsigned int blockCount = DISK.FAT.bitVector.size();
+	//Pooenie kolejnych obszarw obrazu
+	const unsigned int fatOffset = SUPERBLOCK_SIZE;
+	const unsigned int bitmapOffset = fatOffset + blockCount * 2;
+	const unsigned int checksumOffset = bitmapOffset + (blockCount + 7) / 8;
+	const unsigned int dataOffset = checksumOffset + blockCount * 4;
+
+	//Obszary o staym pooeniu: tablica FAT, wektor bitowy, sumy kontrolne i dane
+	std::string image(SUPERBLOCK_SIZE, '\0');
+	for (const unsigned int &next : DISK.FAT.FileAllocationTable) {
+		AppendNumber(image, next == -1 ? 0xFFFF : next, 2);
+	}
+	for (unsigned int i = 0; i < blockCount; i += 8) {
+		unsigned int byte = 0;
+		for (unsigned int bit = 0; bit < 8 && i + bit < blockCount; bit++) {
+			if (DISK.FAT.bitVector[i + bit]) { byte |= 1 << bit; }
+		}
+		AppendNumber(image, byte, 1);
+	}
+	for (const unsigned int &checksum : DISK.FAT.checksums) { AppendNumber(image, checksum, 4); }
+	for (unsigned int index = 0; index < DISK_CAPACITY; index++) { image += DISK.at(index); }
+
+	//Rekordy katalogw, katalog gwny zapisywany jest jako ostatni
+	const unsigned int rootOffset = AppendDirectoryRecord(image, DISK.FAT.rootDirectory);
+
+	//Superblok
+	std::string superblock;
+	AppendNumber(superblock, IMAGE_MAGIC, 4);
+	AppendNumber(superblock, IMAGE_VERSION, 2);
+	AppendNumber(superblock, BLOCK_SIZE, 2);
+	AppendNumber(superblock, blockCount, 4);
+	AppendNumber(superblock, DISK.FAT.freeSpace, 4);
+	AppendNumber(superblock, fatOffset, 4);
+	AppendNumber(superblock, bitmapOffset, 4);
+	AppendNumber(superblock, dataOffset, 4);
+	AppendNumber(superblock, rootOffset, 4);
+	AppendNumber(superblock, DISK.FAT.fileCount, 4);
+	AppendNumber(superblock, DISK.FAT.contiguousFileCount, 4);
+	AppendNumber(superblock, DISK.FAT.fragmentCount, 4);
+	AppendNumber(superblock, DISK.devices.size(), 4);
+	AppendNumber(superblock, DISK.FAT.reservedSpace, 4);
+	AppendNumber(superblock, checksumOffset, 4);
+	image.replace(0, superblock.size(), superblock);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cout << "Nie mona otworzy pliku obrazu '" << path << "'!\n";
+		return;
+	}
+	file.write(image.data(), image.size());
+	if (messages) { std::cout << "Zapisano obraz dysku '" << path << "' (" << image.size() << " Bajtw).\n"; }
+}
+
+void FileManager::DiskMount(const std::string &path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		std::cout << "Nie mona otworzy pliku obrazu '" << path << "'!\n";
+		return;
+	}
+
+	//Superblok
+	const unsigned int magic = ReadNumber(file, 4);
+	const unsigned int version = ReadNumber(file, 2);
+	const unsigned int blockSize = ReadNumber(file, 2);
+	const unsigned int blockCount = ReadNumber(file, 4);
+	if (!file || magic != IMAGE_MAGIC || version != IMAGE_VERSION || blockSize != BLOCK_SIZE || blockCount != DISK.FAT.bitVector.size()) {
+		std::cout << "Plik '" << path << "' nie jest poprawnym obrazem dysku!\n";
+		return;
+	}
+	const unsigned int freeSpace = ReadNumber(file, 4);
+	const unsigned int fatOffset = ReadNumber(file, 4);
+	const unsigned int bitmapOffset = ReadNumber(file, 4);
+	const unsigned int dataOffset = ReadNumber(file, 4);
+	const unsigned int rootOffset = ReadNumber(file, 4);
+
+	//Nowy, pusty dysk
+	DISK = Disk();
+	currentDirectory = &DISK.FAT.rootDirectory;
+	openFiles.clear();
+	DISK.FAT.fileCount = ReadNumber(file, 4);
+	DISK.FAT.contiguousFileCount = ReadNumber(file, 4);
+	DISK.FAT.fragmentCount = ReadNumber(file, 4);
+	//Starsze obrazy maj w tym miejscu zero - wolumin z jednego urzdzenia
+	const unsigned int deviceCount = ReadNumber(file, 4);
+	if (deviceCount > 1 && deviceCount <= blockCount) { DISK.Stripe(deviceCount); }
+	//Rezerwacje plikw w niewczytanych katalogach s znane tylko z superbloku
+	DISK.FAT.reservedSpace = ReadNumber(file, 4);
+	const unsigned int checksumOffset = ReadNumber(file, 4);
+
+	//Tablica FAT
+	file.seekg(fatOffset);
+	for (unsigned int &next : DISK.FAT.FileAllocationTable) {
+		next = ReadNumber(file, 2);
+		if (next == 0xFFFF) { next = -1; }
+	}
+	//Wektor bitowy (zajmowanie blokw odtwarza statystyki wolnego miejsca)
+	file.seekg(bitmapOffset);
+	for (unsigned int i = 0; i < blockCount; i += 8) {
+		const unsigned int byte = ReadNumber(file, 1);
+		for (unsigned int bit = 0; bit < 8 && i + bit < blockCount; bit++) {
+			if (byte & (1 << bit)) { ChangeBitVectorValue(i + bit, 1); }
+		}
+	}
+	//Dane
+	file.seekg(dataOffset);
+	std::string data(DISK_CAPACITY, '\0');
+	file.read(&data[0], data.size());
+	for (unsigned int index = 0; index < data.size(); index++) { DISK.at(index) = data[index]; }
+	//Sumy kontrolne z obrazu wykryj dane uszkodzone poza systemem, starsze obrazy ich nie maj
+	if (checksumOffset != 0) {
+		file.seekg(checksumOffset);
+		for (unsigned int &checksum : DISK.FAT.checksums) { checksum = ReadNumber(file, 4); }
+	}
+	else { DISK.UpdateChecksums(0, DISK_CAPACITY - 1); }
+
+	if (!file || DISK.FAT.freeSpace != freeSpace) {
+		std::cout << "Obraz dysku '" << path << "' jest uszkodzony!\n";
+	}
+
+	//Katalog gwny, pozostae katalogi wczytywane s przy pierwszym uyciu
+	imagePath = path;
+	DISK.FAT.rootDirectory.loaded = false;
+	DISK.FAT.rootDirectory.imageOffset = rootOffset;
+	LoadDirectory(DISK.FAT.rootDirectory);
+
+	//Indeks nazw budowany jest od nowa dla zamontowanego dysku
+	if (nameIndexEnabled) { NameIndexEnable(true); }
+
+	if (messages) { std::cout << "Zamontowano dysk z obrazu '" << path << "'.\n"; }
+}
+
+void FileManager::NameIndexEnable(const bool &enabled) {
+	nameIndex.clear();
+	suffixIndex.clear();
+	nameIndexEnabled = enabled;
+	if (enabled) { NameIndexDirectory(DISK.FAT.rootDirectory, '/' + DISK.FAT.rootDirectory.name); }
+}
+
+const std::vector<std::string> FileManager::FindByPrefix(const std::string &prefix) {
+	return NameIndexRange(nameIndex, prefix);
+}
+
+const std::vector<std::string> FileManager::FindBySubstring(const std::string &text) {
+	//Cig jest podcigiem nazwy, jeli jest przedrostkiem ktrego z jej przyrostkw
+	return NameIndexRange(suffixIndex, text);
+}
+
+void FileManager::Search(const SearchQuery &query, const std::function<void(const SearchResult &)> &callback) {
+	if (!threadPool) { threadPool = std::unique_ptr<ThreadPool>(new ThreadPool()); }
+	//Blokada, dziki ktrej wywoania funkcji zwrotnej nie nakadaj si
+	std::mutex callbackMutex;
+
+	//Przeglda jeden katalog i zleca przegldanie jego podkatalogw jako osobne zadania
+	std::function<void(Directory &, const std::string &)> visit = [&](Directory &directory, const std::string &path) {
+		LoadDirectory(directory);
+		for (const auto &entry : directory.files) {
+			const File &file = entry.second;
+			const unsigned long long modified = TimeToNumber(file.modificationTime);
+			if (file.sizeOnDisk >= query.minSize && file.sizeOnDisk <= query.maxSize
+				&& modified >= query.modifiedAfter && modified <= query.modifiedBefore
+				&& MatchPattern(file.name, query.pattern)) {
+				const SearchResult result{ path + '/' + file.name, file.sizeOnDisk, file.modificationTime };
+				std::lock_guard<std::mutex> lock(callbackMutex);
+				callback(result);
+			}
+		}
+		for (auto &dir : directory.subDirectories) {
+			Directory *subDirectory = &dir.second;
+			const std::string subPath = path + '/' + dir.first;
+			threadPool->Submit([&visit, subDirectory, subPath] { visit(*subDirectory, subPath); });
+		}
+	};
+
+	Directory *start = currentDirectory;
+	const std::string startPath = GetCurrentPath();
+	threadPool->Submit([&visit, start, startPath] { visit(*start, startPath); });
+	threadPool->Wait();
+}
+
+const FileManager::CheckReport FileManager::DiskCheck(const bool &repair) {
+	CheckReport report;
+	const unsigned int blockCount = DISK.FAT.bitVector.size();
+	const BitVector &bitVector = DISK.FAT.bitVector;
+	const auto &table = DISK.FAT.FileAllocationTable;
+	//Sprawdzanie korzysta z tej samej puli wtkw co wyszukiwanie
+	if (!threadPool) { threadPool = std::unique_ptr<ThreadPool>(new ThreadPool()); }
+	//Liczba czci, na ktre dzielona jest praca (po jednej na wtek puli)
+	const unsigned int threadCount = threadPool->Size();
+
+	//Wszystkie pliki na dysku
+	std::vector<File*> files;
+	CollectFiles(DISK.FAT.rootDirectory, files);
+	report.checkedFiles = files.size();
+
+	//Liczba acuchw przechodzcych przez kady blok
+	std::unique_ptr<std::atomic<unsigned int>[]> references(new std::atomic<unsigned int>[blockCount]());
+	//Czy acuch danego pliku jest uszkodzony
+	std::vector<char> broken(files.size(), 0);
+
+	//Dzieli przedzia [0, count) na rwne czci i zleca je jako zadania puli wtkw
+	const auto runParallel = [this, &threadCount](const size_t &count, const std::function<void(size_t, size_t, unsigned int)> &work) {
+		const size_t chunk = (count + threadCount - 1) / threadCount;
+		for (unsigned int t = 0; t < threadCount && t * chunk < count; t++) {
+			const size_t begin = t * chunk;
+			const size_t end = std::min(count, (t + 1) * chunk);
+			threadPool->Submit([&work, begin, end, t] { work(begin, end, t); });
+		}
+		threadPool->Wait();
+	};
+
+	//Etap 1 - przejcie acuchw plikw i zliczenie odwoa do blokw
+	runParallel(files.size(), [&](size_t begin, size_t end, unsigned int) {
+		for (size_t i = begin; i < end; i++) {
+			const File &file = *files[i];
+			//Liczba blokw, ktre powinny znajdowa si w acuchu
+			const unsigned int expected = file.inlined ? 0 : file.size / BLOCK_SIZE - file.holes.size();
+			unsigned int index = file.FATindex;
+			unsigned int step = 0;
+			for (; step < expected && index != -1 && index < blockCount; step++) {
+				references[index]++;
+				index = table[index];
+			}
+			//acuch za krtki, za dugi lub wskazujcy poza dysk
+			if (step < expected || index != -1) { broken[i] = 1; }
+			//Zarezerwowane bloki nale do pliku, cho nie ma ich w acuchu
+			for (const unsigned int &block : file.reserved) {
+				if (block < blockCount) { references[block]++; }
+				else { broken[i] = 1; }
+			}
+		}
+	});
+	for (const char &chain : broken) { report.brokenChains += chain; }
+
+	//Etap 2 - porwnanie odwoa z wektorem bitowym i tablic FAT
+	//Wyniki czciowe wtkw: skrzyowane, wycieke, nieoznaczone, zbdne wpisy, wolne
+	std::vector<std::array<unsigned int, 5>> partial(threadCount, std::array<unsigned int, 5>{});
+	runParallel(blockCount, [&](size_t begin, size_t end, unsigned int thread) {
+		for (size_t block = begin; block < end; block++) {
+			const unsigned int count = references[block];
+			if (count > 1) { partial[thread][0]++; }
+			if (bitVector[block] == 1 && count == 0) { partial[thread][1]++; }
+			if (bitVector[block] == 0 && count > 0) { partial[thread][2]++; }
+			if (count == 0 && table[block] != -1) { partial[thread][3]++; }
+			if (bitVector[block] == 0) { partial[thread][4]++; }
+		}
+	});
+	for (const auto &result : partial) {
+		report.crossLinkedBlocks += result[0];
+		report.leakedBlocks += result[1];
+		report.unmarkedBlocks += result[2];
+		report.strayEntries += result[3];
+		report.countedFreeSpace += result[4] * BLOCK_SIZE;
+	}
+	report.recordedFreeSpace = DISK.FAT.freeSpace;
+
+	const bool errors = report.brokenChains + report.crossLinkedBlocks + report.leakedBlocks + report.unmarkedBlocks
+		+ report.strayEntries > 0 || report.countedFreeSpace != report.recordedFreeSpace;
+
+	if (repair && errors) {
+		//Bloki przypisane ju do ktrego pliku
+		std::vector<bool> claimed(blockCount, false);
+
+		//Naprawa acuchw - plik obcinany jest na pierwszym bdnym lub zajtym ju bloku
+		for (File *file : files) {
+			if (file->inlined) { continue; }
+			//Pozostawione bloki logiczne pliku
+			std::vector<unsigned int> blocks;
+			const unsigned int logicalBlocks = file->size / BLOCK_SIZE;
+			unsigned int index = file->FATindex;
+			for (unsigned int i = 0; i < logicalBlocks; i++) {
+				if (file->holes.find(i) != file->holes.end()) { blocks.push_back(-1); continue; }
+				if (index == -1 || index >= blockCount || claimed[index]) { break; }
+				claimed[index] = true;
+				blocks.push_back(index);
+				index = table[index];
+			}
+			if (blocks.size() < logicalBlocks) {
+				file->size = blocks.size() * BLOCK_SIZE;
+				file->sizeOnDisk = std::min(file->sizeOnDisk, file->size);
+			}
+			LinkFileBlocks(*file, blocks);
+		}
+		//Rezerwacje zachowuj tylko bloki nieprzypisane do adnego acucha
+		for (File *file : files) {
+			std::vector<unsigned int> reserved;
+			for (const unsigned int &block : file->reserved) {
+				if (block < blockCount && !claimed[block]) {
+					claimed[block] = true;
+					reserved.push_back(block);
+				}
+			}
+			file->reserved = reserved;
+		}
+
+		//Odtworzenie wektora bitowego z acuchw i wyczyszczenie wpisw wolnych blokw
+		for (unsigned int block = 0; block < blockCount; block++) {
+			DISK.FAT.bitVector[block] = claimed[block];
+			if (!claimed[block]) { DISK.FAT.FileAllocationTable[block] = -1; }
+		}
+		RebuildStatistics();
+		//Naprawione acuchy uniewaniaj kursory otwartych plikw
+		for (auto &openFile : openFiles) { OpenFileInvalidate(openFile.first); }
+		report.repaired = true;
+	}
+
+	return report;
+}
+
+const bool FileManager::SwapCreate(const unsigned int &size) {
+	Directory &root = DISK.FAT.rootDirectory;
+	if (GetSwapFile() != nullptr) {
+		std::cout << "Plik wymiany ju istnieje!\n";
+		return false;
+	}
+	if (!CheckIfNameUnused(root, SWAP_FILE_NAME)) {
+		std::cout << "Nazwa pliku '" << SWAP_FILE_NAME << "' ju zajta!\n";
+		return false;
+	}
+	if (root.files.size() + root.subDirectories.size() >= MAX_DIRECTORY_ELEMENTS) {
+		std::cout << "Osignito limit elementw w ciece '/" << root.name << "'!\n";
+		return false;
+	}
+
+	//Plik wymiany musi zajmowa jeden cigy obszar
+	const unsigned int blockCount = std::max(1u, (size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+	const std::vector<unsigned int> blocks = FindContiguousBlocks(blockCount);
+	if (blocks.empty()) {
+		std::cout << "Brak cigego obszaru " << blockCount << " blokw na plik wymiany!\n";
+		return false;
+	}
+
+	File file(SWAP_FILE_NAME);
+	file.swap = true;
+	file.size = blockCount * BLOCK_SIZE;
+	file.sizeOnDisk = file.size;
+	file.creationTime = GetCurrentTimeAndDate();
+	file.modificationTime = file.creationTime;
+	ChangeFileStatistics(file, true);
+	LinkFileBlocks(file, blocks);
+	for (const unsigned int &block : blocks) { ChangeBitVectorValue(block, 1); }
+	DISK.write(blocks.front() * BLOCK_SIZE, (blocks.back() + 1) * BLOCK_SIZE - 1, std::string(file.size, '\0'));
+
+	root.files[file.name] = file;
+	NameIndexAdd(file.name, '/' + root.name + '/' + file.name);
+
+	if (messages) { std::cout << "Stworzono plik wymiany o rozmiarze " << file.size << " Bajtw.\n"; }
+	return true;
+}
+
+const std::string FileManager::SwapRead(const unsigned int &offset, const unsigned int &length) {
+	const File* swap = GetSwapFile();
+	if (swap == nullptr || length == 0 || offset + length > swap->size) {
+		std::cout << "Niepoprawny odczyt pliku wymiany!\n";
+		return "";
+	}
+	//Plik jest cigy, wic przedzia pliku to przedzia dysku
+	const unsigned int begin = swap->FATindex * BLOCK_SIZE + offset;
+	return DISK.read<std::string>(begin, begin + length - 1);
+}
+
+const bool FileManager::SwapWrite(const unsigned int &offset, const std::string &data) {
+	File* swap = GetSwapFile();
+	if (swap == nullptr || data.empty() || offset + data.size() > swap->size) {
+		std::cout << "Niepoprawny zapis pliku wymiany!\n";
+		return false;
+	}
+	const unsigned int begin = swap->FATindex * BLOCK_SIZE + offset;
+	DISK.write(begin, begin + data.size() - 1, data);
+	return true;
+}
+
+const int FileManager::FileGetSize(const std::string &path) {
+	const File* file = FindFile(path);
+	if (file == nullptr) {
+		std::cout << "Plik '" << path << "' nie istnieje!\n";
+		return -1;
+	}
+	return file->sizeOnDisk;
+}
+
+const std::string FileManager::FileReadRange(const std::string &path, const unsigned int &offset, const unsigned int &length) {
+	const File* file = FindFile(path);
+	if (file == nullptr) {
+		std::cout << "Plik '" << path << "' nie istnieje!\n";
+		return "";
+	}
+	if (offset >= file->sizeOnDisk) { return ""; }
+	//Dane odczytywane s prosto do wyniku
+	std::string data(std::min((unsigned int)file->sizeOnDisk, offset + length) - offset, '\0');
+	//Przy uszkodzonych blokach nic nie zostao odczytane
+	data.resize(FileReadVectored(path, offset, { ReadBuffer{ &data[0], data.size() } }));
+	return data;
+}
+
+const unsigned int FileManager::FileReadVectored(const std::string &path, const unsigned int &offset, const std::vector<ReadBuffer> &buffers) {
+	const File* file = FindFile(path);
+	if (file == nullptr) {
+		std::cout << "Plik '" << path << "' nie istnieje!\n";
+		return 0;
+	}
+	//Pooenie pocztku kadego bufora w odczytywanym przedziale
+	const std::vector<size_t> starts = BufferStarts(buffers);
+	if (offset >= file->sizeOnDisk || starts.back() == 0) { return 0; }
+	const unsigned int end = std::min((unsigned int)file->sizeOnDisk, offset + (unsigned int)starts.back());
+
+	//Dane przechowywane w pamici kopiowane s bezporednio
+	if (file->inlined || file->delayed) {
+		const std::string &content = file->inlined ? file->inlineData : file->buffer;
+		unsigned int position = offset;
+		for (const ReadBuffer &piece : SliceBuffers(buffers, starts, 0, end - offset)) {
+			content.copy(piece.data, piece.length, position);
+			position += piece.length;
+		}
+		return end - offset;
+	}
 
-				if (messages) { std::cout << "Zmieniono nazw pliku '" << name << "' na '" << currentDirectory->files[changeName].name << "'.\n"; }
-				return;
-			}
-			else { std::cout << "cieka za duga!\n"; }
+	//Pierwszy i ostatni (wycznie) blok logiczny obejmujcy przedzia
+	const unsigned int firstBlock = offset / BLOCK_SIZE;
+	const unsigned int lastBlock = (end - 1) / BLOCK_SIZE + 1;
+
+	//Bloki przed przedziaem s tylko przechodzone w tablicy FAT (dziura nie zajmuje pozycji w acuchu)
+	unsigned int index = file->FATindex;
+	for (unsigned int i = 0; i < firstBlock; i++) {
+		if (file->holes.find(i) == file->holes.end()) { index = DISK.FAT.FileAllocationTable[index]; }
+	}
+
+	//Czci buforw odczytywane jedn operacj dysku (cigy obszar blokw fizycznych)
+	std::vector<ReadBuffer> run;
+	unsigned int runBegin = 0, runEnd = 0;
+	//Czy ktry obszar by uszkodzony
+	bool corrupt = false;
+	const auto readRun = [&] {
+		if (!run.empty() && !DISK.read(runBegin, run)) { corrupt = true; }
+		run.clear();
+	};
+
+	for (unsigned int i = firstBlock; i < lastBlock; i++) {
+		const unsigned int begin = std::max(offset, i*BLOCK_SIZE);
+		const unsigned int stop = std::min(end, (i + 1)*BLOCK_SIZE);
+		const std::vector<ReadBuffer> pieces = SliceBuffers(buffers, starts, begin - offset, stop - begin);
+
+		//Dziura odczytywana jest jako zera, bez odwoywania si do dysku
+		if (file->holes.find(i) != file->holes.end()) {
+			readRun();
+			for (const ReadBuffer &piece : pieces) { std::fill(piece.data, piece.data + piece.length, '\0'); }
+			continue;
 		}
-		else {
-			std::cout << "Nazwa pliku '" << changeName << "' ju zajta!\n";
+
+		const unsigned int address = index * BLOCK_SIZE + begin - i * BLOCK_SIZE;
+		if (run.empty() || address != runEnd) {
+			readRun();
+			runBegin = address;
+			runEnd = address;
 		}
+		run.insert(run.end(), pieces.begin(), pieces.end());
+		runEnd += stop - begin;
+		index = DISK.FAT.FileAllocationTable[index];
 	}
-	else { std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n"; }
+	readRun();
+	if (corrupt) {
+		std::cout << "Plik '" << path << "' zawiera uszkodzone bloki - dane nie zostay odczytane!\n";
+		return 0;
+	}
+	return end - offset;
 }
 
-void FileManager::DirectoryRoot() {
-	while (currentDirectory->parentDirectory != NULL) {
-		DirectoryUp();
-	}
+const FileManager::ScrubReport FileManager::DiskScrub() {
+	ScrubReport report;
+	report.checkedBlocks = DISK.FAT.bitVector.size();
+	report.corruptBlocks = DISK.Scrub();
+	report.hardwareAccelerated = Checksum::HardwareAccelerated();
+	return report;
+}
+
+const FileManager::FragmentationReport FileManager::GetFragmentationReport() {
+	FragmentationReport report;
+	report.freeBlocks = DISK.FAT.freeSpace / BLOCK_SIZE;
+	report.freeExtentCount = DISK.FAT.freeExtents.size();
+	report.largestFreeExtent = CalculateLargestFreeExtent();
+	report.freeExtentHistogram = DISK.FAT.freeExtentHistogram;
+	report.fileCount = DISK.FAT.fileCount;
+	report.contiguousFileCount = DISK.FAT.contiguousFileCount;
+	report.fragmentsPerFile = DISK.FAT.fileCount == 0 ? 0 : (double)DISK.FAT.fragmentCount / DISK.FAT.fileCount;
+	report.contiguousFileShare = DISK.FAT.fileCount == 0 ? 1 : (double)DISK.FAT.contiguousFileCount / DISK.FAT.fileCount;
+	return report;
 }
 
 //------------------ Metody do wywietlania -----------------
@@ -315,7 +1587,7 @@ void FileManager::Messages(const bool &onOff) {
 void FileManager::DisplayDirectoryInfo(const std::string &name) {
 	auto directoryIterator = currentDirectory->subDirectories.find(name);
 	if (directoryIterator != currentDirectory->subDirectories.end()) {
-		const Directory directory = directoryIterator->second;
+		Directory &directory = directoryIterator->second;
 		std::cout << "Name: " << directory.name << '\n';
 		std::cout << "Size: " << CalculateDirectorySize(directory) << " Bytes\n";
 		std::cout << "Size on disk: " << CalculateDirectorySize(directory) << " Bytes\n";
@@ -332,9 +1604,14 @@ void FileManager::DisplayFileInfo(const std::string &name) {
 		std::cout << "Name: " << file.name << '\n';
 		std::cout << "Size: " << file.size << " Bytes\n";
 		std::cout << "Size on disk: " << file.sizeOnDisk << " Bytes\n";
+		std::cout << "Allocated: " << file.size - file.holes.size()*BLOCK_SIZE << " Bytes (" << file.holes.size() << " holes)\n";
+		std::cout << "Fragments: " << file.fragments << '\n';
+		std::cout << "Reserved: " << file.reserved.size() * BLOCK_SIZE << " Bytes\n";
 		std::cout << "Created: " << file.creationTime << '\n';
 		std::cout << "Modified: " << file.modificationTime << '\n';
-		std::cout << "FAT index: " << file.FATindex << '\n';
+		if (file.inlined) { std::cout << "Stored: inline (directory entry)\n"; }
+		else if (file.delayed) { std::cout << "Stored: buffered (delayed allocation)\n"; }
+		else { std::cout << "FAT index: " << file.FATindex << '\n'; }
 		std::cout << "Saved data: " << FileGetData(file) << '\n';
 	}
 	else { std::cout << "Plik o nazwie '" << name << "' nie znaleziony w ciece '" + GetCurrentPath() + "'!\n"; }
@@ -343,7 +1620,8 @@ void FileManager::DisplayFileInfo(const std::string &name) {
 void FileManager::DisplayDirectoryStructure() {
 	DisplayDirectory(DISK.FAT.rootDirectory, 1);
 }
-void FileManager::DisplayDirectory(const Directory &directory, unsigned int level) {
+void FileManager::DisplayDirectory(Directory &directory, unsigned int level) {
+	LoadDirectory(directory);
 	std::cout << std::string(level, ' ') << directory.name << "\\\n";
 	for (auto i = directory.files.begin(); i != directory.files.end(); i++) {
 		std::cout << std::string(level + 1, ' ') << "- " << i->first << '\n';
@@ -355,23 +1633,21 @@ void FileManager::DisplayDirectory(const Directory &directory, unsigned int leve
 }
 
 void FileManager::DisplayDiskContentBinary() {
-	unsigned int index = 0;
-	for (const char &c : DISK.space) {
+	for (unsigned int index = 0; index < DISK_CAPACITY; index++) {
+		const char c = DISK.at(index);
 		//bitset - tablica bitowa
 		std::cout << std::bitset<8>(c) << (index % BLOCK_SIZE == BLOCK_SIZE - 1 ? " , " : "") << (index % 16 == 15 ? " \n" : " ");
-		index++;
 	}
 	std::cout << '\n';
 }
 
 void FileManager::DisplayDiskContentChar() {
-	unsigned int index = 0;
-	for (const char &c : DISK.space) {
+	for (unsigned int index = 0; index < DISK_CAPACITY; index++) {
+		const char c = DISK.at(index);
 		if (c == ' ') { std::cout << ' '; }
 		else if (c >= 0 && c <= 32) std::cout << ".";
 		else std::cout << c;
 		std::cout << (index % BLOCK_SIZE == BLOCK_SIZE - 1 ? " , " : "") << (index % 32 == 31 ? " \n" : " ");
-		index++;
 	}
 	std::cout << '\n';
 }
@@ -403,9 +1679,173 @@ void FileManager::DisplayFileFragments(const std::vector<std::string> &fileFragm
 	}
 }
 
+void FileManager::DisplayAllocationPolicyComparison(const unsigned int &operations, const unsigned int &seed) {
+	const AllocationPolicyType types[] = { AllocationPolicyType::NextFit, AllocationPolicyType::FirstFit,
+		AllocationPolicyType::WorstFit, AllocationPolicyType::BestFit, AllocationPolicyType::AlignedFit };
+	//Co ile operacji zapisywany jest najwikszy wolny obszar
+	const unsigned int checkpoint = std::max(operations / 10, 1u);
+
+	std::cout << std::left << std::setw(13) << "Policy" << std::setw(12) << "Ops/s" << std::setw(10) << "Avg scan"
+		<< std::setw(12) << "Fragmented" << std::setw(10) << "External" << "Largest free extent over time (blocks)\n";
+
+	for (const AllocationPolicyType &type : types) {
+		//Kada strategia dostaje osobny, pusty dysk
+		FileManager volume;
+		volume.SetAllocationPolicy(type);
+		//Ten sam cig losowy dla kadej strategii
+		std::mt19937 generator(seed);
+
+		//Nazwy istniejcych plikw
+		std::vector<std::string> names;
+		//Numer do tworzenia unikalnych nazw
+		unsigned int nameCounter = 0;
+		//Liczba wykonanych alokacji
+		unsigned int allocations = 0;
+		//Najwikszy wolny obszar w kolejnych punktach kontrolnych
+		std::vector<unsigned int> largestExtents;
+
+		const auto begin = std::chrono::steady_clock::now();
+		for (unsigned int operation = 0; operation < operations; operation++) {
+			//Rozmiar pliku od 2 do 9 blokw, zawsze wikszy od MAX_INLINE_SIZE
+			const unsigned int size = (generator() % 8 + 2) * BLOCK_SIZE - generator() % BLOCK_SIZE;
+			const bool create = names.empty() || (names.size() < MAX_DIRECTORY_ELEMENTS && generator() % 2 == 0);
+
+			if (create && volume.CheckIfEnoughSpace(CalculateNeededBlocks(std::string(size, ' '))*BLOCK_SIZE)) {
+				names.push_back('f' + std::to_string(nameCounter++));
+				volume.FileCreate(names.back(), std::string(size, 'x'));
+				allocations++;
+			}
+			else if (!names.empty()) {
+				//Usunicie losowego pliku
+				const unsigned int index = generator() % names.size();
+				volume.FileDelete(names[index]);
+				names.erase(names.begin() + index);
+			}
+
+			if ((operation + 1) % checkpoint == 0) { largestExtents.push_back(volume.CalculateLargestFreeExtent()); }
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		const FragmentationReport report = volume.GetFragmentationReport();
+		//Fragmentacja zewntrzna - cz wolnego miejsca poza najwikszym wolnym obszarem
+		const double external = report.freeBlocks == 0 ? 0 : 1.0 - (double)report.largestFreeExtent / report.freeBlocks;
+
+		std::cout << std::setw(13) << volume.allocationPolicy->Name()
+			<< std::setw(12) << (unsigned long long)(seconds > 0 ? operations / seconds : 0)
+			<< std::setw(10) << std::fixed << std::setprecision(2) << (allocations == 0 ? 0.0 : (double)volume.allocationPolicy->scanCost / allocations)
+			<< std::setw(12) << 100.0 * (1.0 - report.contiguousFileShare)
+			<< std::setw(10) << 100.0 * external;
+		for (const unsigned int &extent : largestExtents) { std::cout << extent << ' '; }
+		std::cout << '\n';
+	}
+	std::cout << std::right;
+}
+
+void FileManager::DisplayDiskCheck(const bool &repair) {
+	const CheckReport report = DiskCheck(repair);
+	std::cout << "Checked files: " << report.checkedFiles << '\n';
+	std::cout << "Broken chains: " << report.brokenChains << '\n';
+	std::cout << "Cross-linked blocks: " << report.crossLinkedBlocks << '\n';
+	std::cout << "Leaked blocks: " << report.leakedBlocks << '\n';
+	std::cout << "Unmarked blocks: " << report.unmarkedBlocks << '\n';
+	std::cout << "Stray FAT entries: " << report.strayEntries << '\n';
+	std::cout << "Free space: " << report.recordedFreeSpace << " Bytes recorded, " << report.countedFreeSpace << " Bytes counted\n";
+	if (report.repaired) { std::cout << "Errors repaired.\n"; }
+}
+
+void FileManager::DisplayDiskScrub() {
+	const ScrubReport report = DiskScrub();
+	std::cout << "Checked blocks: " << report.checkedBlocks << " (CRC32C, " << (report.hardwareAccelerated ? "hardware" : "software") << ")\n";
+	std::cout << "Corrupt blocks: " << report.corruptBlocks.size();
+	for (const unsigned int &block : report.corruptBlocks) { std::cout << ' ' << block; }
+	std::cout << '\n';
+}
+
+void FileManager::DisplaySearchResults(const SearchQuery &query) {
+	unsigned int found = 0;
+	Search(query, [&found](const SearchResult &result) {
+		std::cout << result.path << " (" << result.size << " Bytes, modified " << result.modificationTime << ")\n";
+		found++;
+	});
+	std::cout << "Found " << found << " files.\n";
+}
+
+void FileManager::DisplayReadAheadStatistics() {
+	const ReadAheadStatistics &stats = readAheadStatistics;
+	std::cout << "Requested blocks: " << stats.requestedBlocks << '\n';
+	std::cout << "Read-ahead hits: " << stats.readAheadHits << " ("
+		<< (stats.requestedBlocks == 0 ? 0.0 : 100.0 * stats.readAheadHits / stats.requestedBlocks) << "%)\n";
+	std::cout << "Read-ahead blocks: " << stats.readAheadBlocks << ", wasted: " << stats.wastedBlocks << '\n';
+	std::cout << "Device reads: " << stats.deviceReads << '\n';
+}
+
+void FileManager::DisplayStripingBenchmark(const std::vector<unsigned int> &deviceCounts, const unsigned int &fileSize) {
+	std::cout << std::setfill(' ') << std::left << std::setw(9) << "Devices" << std::setw(12) << "Write time" << std::setw(11) << "Read time"
+		<< std::setw(14) << "Write B/unit" << std::setw(13) << "Read B/unit" << "Read speedup\n";
+
+	//Czas odczytu na pierwszym woluminie (punkt odniesienia)
+	unsigned long long baseline = 0;
+	for (const unsigned int &count : deviceCounts) {
+		//Kada liczba urzdze dostaje osobny, pusty wolumin
+		FileManager volume;
+		volume.VolumeSetDevices(count);
+		if (volume.DISK.devices.size() != count) { continue; }
+		if (fileSize <= MAX_INLINE_SIZE || !volume.CheckIfEnoughSpace(CalculateNeededBlocks(std::string(fileSize, ' '))*BLOCK_SIZE)) {
+			std::cout << "Podano niepoprawny rozmiar!\n";
+			return;
+		}
+
+		//Zapis sekwencyjny caego pliku
+		unsigned long long start = volume.DISK.elapsedTime;
+		volume.FileCreate("benchmark", std::string(fileSize, 'x'));
+		const unsigned long long writeTime = volume.DISK.elapsedTime - start;
+		//Odczyt sekwencyjny caego pliku
+		start = volume.DISK.elapsedTime;
+		volume.FileReadRange('/' + volume.DISK.FAT.rootDirectory.name + "/benchmark", 0, fileSize);
+		const unsigned long long readTime = volume.DISK.elapsedTime - start;
+
+		if (baseline == 0) { baseline = readTime; }
+		std::cout << std::setw(9) << count << std::setw(12) << writeTime << std::setw(11) << readTime
+			<< std::setw(14) << std::fixed << std::setprecision(2) << (double)fileSize / writeTime
+			<< std::setw(13) << (double)fileSize / readTime << (double)baseline / readTime << "x\n";
+	}
+	std::cout << std::right;
+}
+
+void FileManager::DisplayDevices() {
+	std::cout << std::setfill(' ') << std::left << std::setw(8) << "Device" << std::setw(8) << "Blocks" << std::setw(12) << "Free (B)"
+		<< std::setw(10) << "Requests" << std::setw(13) << "Transferred" << "Busy time\n";
+	for (unsigned int i = 0; i < DISK.devices.size(); i++) {
+		const Disk::Device &device = DISK.devices[i];
+		std::cout << std::setw(8) << i << std::setw(8) << device.space.size() / BLOCK_SIZE << std::setw(12) << device.freeSpace
+			<< std::setw(10) << device.requests << std::setw(13) << device.blocks << device.busyTime << '\n';
+	}
+	std::cout << std::right;
+	std::cout << "Volume time: " << DISK.elapsedTime << '\n';
+	std::cout << "Checksum errors: " << DISK.checksumErrors << '\n';
+}
+
+void FileManager::DisplayFragmentationReport() {
+	const FragmentationReport report = GetFragmentationReport();
+	std::cout << "Free blocks: " << report.freeBlocks << " (" << report.freeExtentCount << " extents)\n";
+	std::cout << "Largest free extent: " << report.largestFreeExtent << " Blocks\n";
+	std::cout << "Free extent histogram:\n";
+	for (unsigned int i = 0; i < report.freeExtentHistogram.size(); i++) {
+		std::cout << ' ' << std::setfill(' ') << std::setw(3) << (1u << i) << '-' << std::left << std::setw(3) << (2u << i) - 1
+			<< std::right << ": " << report.freeExtentHistogram[i] << '\n';
+	}
+	std::cout << "Files: " << report.fileCount << ", contiguous: " << report.contiguousFileCount
+		<< " (" << report.contiguousFileShare * 100 << "%)\n";
+	std::cout << "Fragments per file: " << report.fragmentsPerFile << '\n';
+	std::cout << "Space: " << DISK_CAPACITY - DISK.FAT.freeSpace - DISK.FAT.reservedSpace << " Bytes used, "
+		<< DISK.FAT.reservedSpace << " Bytes reserved, " << DISK.FAT.freeSpace << " Bytes free ("
+		<< DISK.FAT.delayedSpace << " Bytes awaiting delayed allocation)\n";
+}
+
 //-------------------- Metody Pomocnicze --------------------
 
-const size_t FileManager::CalculateDirectorySize(const Directory &directory) {
+const size_t FileManager::CalculateDirectorySize(Directory &directory) {
+	LoadDirectory(directory);
 	//Rozmiar katalogu
 	size_t size = 0;
 
@@ -414,30 +1854,32 @@ const size_t FileManager::CalculateDirectorySize(const Directory &directory) {
 		size += file.second.size;
 	}
 	//Przeglda katalogi i wywouje na nich obecn funkcj i dodaje zwrcon warto do rozmiaru
-	for (const auto &dir : directory.subDirectories) {
+	for (auto &dir : directory.subDirectories) {
 		size += CalculateDirectorySize(dir.second);
 	}
 
 	return size;
 }
 
-const size_t FileManager::CalculateDirectorySizeOnDisk(const Directory &directory) {
+const size_t FileManager::CalculateDirectorySizeOnDisk(Directory &directory) {
+	LoadDirectory(directory);
 	//Rzeczywisty rozmiar katalogu
 	size_t sizeOnDisk = 9;
 
 	//Dodaje rzeczywisty rozmiar plikw w katalogu do rozmiaru katalogu
-	for (const std::pair<std::string, File> &file : directory.files) {
+	for (const auto &file : directory.files) {
 		sizeOnDisk += file.second.sizeOnDisk;
 	}
 	//Przeglda katalogi i wywouje na nich obecn funkcj i dodaje zwrcon warto do rozmiaru
-	for (const std::pair <std::string, Directory> &dir : directory.subDirectories) {
+	for (auto &dir : directory.subDirectories) {
 		sizeOnDisk += CalculateDirectorySize(dir.second);
 	}
 
 	return sizeOnDisk;
 }
 
-const unsigned int FileManager::CalculateDirectoryFolderCount(const Directory &directory) {
+const unsigned int FileManager::CalculateDirectoryFolderCount(Directory &directory) {
+	LoadDirectory(directory);
 	//Ilo folderw w danym katalogu
 	unsigned int folderCount = 0;
 
@@ -445,13 +1887,14 @@ const unsigned int FileManager::CalculateDirectoryFolderCount(const Directory &d
 	folderCount += directory.subDirectories.size();
 
 	//Przeglda katalogi i wywouje na nich obecn funkcj i dodaje zwrcon warto do iloci
-	for (const std::pair <std::string, Directory> &dir : directory.subDirectories) {
+	for (auto &dir : directory.subDirectories) {
 		folderCount += CalculateDirectoryFolderCount(dir.second);
 	}
 	return folderCount;
 }
 
-const unsigned int FileManager::CalculateDirectoryFileCount(const Directory &directory) {
+const unsigned int FileManager::CalculateDirectoryFileCount(Directory &directory) {
+	LoadDirectory(directory);
 	//Ilo plikw w danym katalogu
 	unsigned int filesCount = 0;
 
@@ -459,17 +1902,21 @@ const unsigned int FileManager::CalculateDirectoryFileCount(const Directory &dir
 	filesCount += directory.files.size();
 
 	//Przeglda katalogi i wywouje na nich obecn funkcj i dodaje zwrcon warto do iloci
-	for (const std::pair <std::string, Directory> &dir : directory.subDirectories) {
+	for (auto &dir : directory.subDirectories) {
 		filesCount += CalculateDirectoryFolderCount(dir.second);
 	}
 	return filesCount;
 }
 
 const std::string FileManager::GetCurrentPath() {
+	return GetDirectoryPath(currentDirectory);
+}
+
+const std::string FileManager::GetDirectoryPath(const Directory* directory) {
 	//cieka
 	std::string path;
 	//Tymczasowa zmienna przechowujca wskanik na katalog
-	Directory* tempDir = currentDirectory;
+	const Directory* tempDir = directory;
 	//Dopki nie doszlimy do pustego katalogu
 	while (tempDir != NULL) {
 		//Dodaj do cieki od przodu nazw obecnego katalogu
@@ -490,10 +1937,14 @@ const tm FileManager::GetCurrentTimeAndDate() {
 }
 
 const size_t FileManager::GetCurrentPathLength() {
+	return GetDirectoryPathLength(currentDirectory);
+}
+
+const size_t FileManager::GetDirectoryPathLength(const Directory* directory) {
 	//cieka
 	size_t length = 0;
 	//Tymczasowa zmienna przechowujca wskanik na katalog
-	Directory* tempDir = currentDirectory;
+	const Directory* tempDir = directory;
 	//Dopki nie doszlimy do pustego katalogu
 	while (tempDir != NULL) {
 		//Dodaj do cieki od przodu nazw obecnego katalogu
@@ -514,36 +1965,385 @@ const bool FileManager::CheckIfNameUnused(const Directory &directory, const std:
 }
 
 const bool FileManager::CheckIfEnoughSpace(const unsigned int &dataSize) {
-	//Jeli dane si mieszcz
-	if (dataSize <= DISK.FAT.freeSpace) { return true; }
+	//Jeli dane si mieszcz (wolne miejsce obiecane buforowanym plikom nie jest dostpne)
+	if (dataSize + DISK.FAT.delayedSpace <= DISK.FAT.freeSpace) { return true; }
 	//Jeli dane si nie mieszcz
 	else { return false; }
 }
 
 void FileManager::ChangeBitVectorValue(const unsigned int &block, const bool &value) {
+	//Jeli blok ma ju podan warto, nic si nie zmienia
+	if (DISK.FAT.bitVector[block] == value) { return; }
+
 	//Jeli warto zajty to wolne miejsce - BLOCK_SIZE
-	if (value == 1) { DISK.FAT.freeSpace -= BLOCK_SIZE; }
+	if (value == 1) {
+		DISK.FAT.freeSpace -= BLOCK_SIZE;
+		DISK.devices[DISK.DeviceOf(block)].freeSpace -= BLOCK_SIZE;
+
+		//Wolny obszar zawierajcy blok (ostatni obszar zaczynajcy si nie dalej ni blok)
+		const auto extent = --DISK.FAT.freeExtents.upper_bound(block);
+		const unsigned int begin = extent->first;
+		const unsigned int length = extent->second;
+		//Podzia obszaru na cz przed i za zajtym blokiem
+		RemoveFreeExtent(begin);
+		if (block > begin) { AddFreeExtent(begin, block - begin); }
+		if (block + 1 < begin + length) { AddFreeExtent(block + 1, begin + length - block - 1); }
+	}
 	//Jeli warto wolny to wolne miejsce + BLOCK_SIZE
-	else if (value == 0) { DISK.FAT.freeSpace += BLOCK_SIZE; }
+	else if (value == 0) {
+		DISK.FAT.freeSpace += BLOCK_SIZE;
+		DISK.devices[DISK.DeviceOf(block)].freeSpace += BLOCK_SIZE;
+
+		//Nowy wolny obszar, czony z ssiednimi wolnymi obszarami
+		unsigned int begin = block;
+		unsigned int length = 1;
+		const auto next = DISK.FAT.freeExtents.find(block + 1);
+		if (next != DISK.FAT.freeExtents.end()) {
+			length += next->second;
+			RemoveFreeExtent(block + 1);
+		}
+		auto previous = DISK.FAT.freeExtents.lower_bound(block);
+		if (previous != DISK.FAT.freeExtents.begin() && (--previous)->first + previous->second == block) {
+			begin = previous->first;
+			length += previous->second;
+			RemoveFreeExtent(begin);
+		}
+		AddFreeExtent(begin, length);
+	}
 	//Przypisanie blokowi podanej wartoci
 	DISK.FAT.bitVector[block] = value;
 }
 
-void FileManager::WriteFile(const File &file, const std::string &data) {
-	//Uzyskuje dane podzielone na fragmenty
-	const std::vector<std::string>fileFragments = DataToDataFragments(data);
-	//Index pod ktrym maj zapisywane by dane
+void FileManager::AddFreeExtent(const unsigned int &begin, const unsigned int &length) {
+	DISK.FAT.freeExtents[begin] = length;
+	DISK.FAT.freeExtentLengths.insert(length);
+	DISK.FAT.freeExtentHistogram[(unsigned int)log2(length)]++;
+}
+
+void FileManager::RemoveFreeExtent(const unsigned int &begin) {
+	const auto extent = DISK.FAT.freeExtents.find(begin);
+	DISK.FAT.freeExtentLengths.erase(DISK.FAT.freeExtentLengths.find(extent->second));
+	DISK.FAT.freeExtentHistogram[(unsigned int)log2(extent->second)]--;
+	DISK.FAT.freeExtents.erase(extent);
+}
+
+void FileManager::FreeBlocks(std::vector<unsigned int> blocks) {
+	std::sort(blocks.begin(), blocks.end());
+	blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+	for (size_t i = 0; i < blocks.size();) {
+		//Cig ssiednich zajtych blokw zaczynajcy si od blocks[i]
+		const unsigned int begin = blocks[i];
+		unsigned int length = 0;
+		for (; i < blocks.size() && blocks[i] == begin + length && DISK.FAT.bitVector[blocks[i]]; i++, length++) {
+			DISK.FAT.bitVector[blocks[i]] = 0;
+			DISK.FAT.FileAllocationTable[blocks[i]] = -1;
+			DISK.devices[DISK.DeviceOf(blocks[i])].freeSpace += BLOCK_SIZE;
+		}
+		//Blok ju wolny jest pomijany
+		if (length == 0) { i++; continue; }
+		DISK.FAT.freeSpace += length * BLOCK_SIZE;
+
+		//Nowy wolny obszar czony z ssiednimi wolnymi obszarami (tak jak w ChangeBitVectorValue)
+		unsigned int extentBegin = begin;
+		unsigned int extentLength = length;
+		const auto next = DISK.FAT.freeExtents.find(begin + length);
+		if (next != DISK.FAT.freeExtents.end()) {
+			extentLength += next->second;
+			RemoveFreeExtent(begin + length);
+		}
+		auto previous = DISK.FAT.freeExtents.lower_bound(begin);
+		if (previous != DISK.FAT.freeExtents.begin() && (--previous)->first + previous->second == begin) {
+			extentBegin = previous->first;
+			extentLength += previous->second;
+			RemoveFreeExtent(extentBegin);
+		}
+		AddFreeExtent(extentBegin, extentLength);
+	}
+}
+
+void FileManager::CollectDirectory(Directory &directory, const std::string &path, std::vector<unsigned int> &blocks, std::vector<std::string> &paths) {
+	LoadDirectory(directory);
+	for (auto &file : directory.files) {
+		//Bloki danych (dziury nie zajmuj blokw, pliki w katalogu i w buforze nie maj blokw)
+		for (unsigned int index = file.second.FATindex; index != -1; index = DISK.FAT.FileAllocationTable[index]) { blocks.push_back(index); }
+		//Zarezerwowane bloki zwalniane s razem z blokami danych
+		blocks.insert(blocks.end(), file.second.reserved.begin(), file.second.reserved.end());
+		DISK.FAT.reservedSpace -= file.second.reserved.size() * BLOCK_SIZE;
+		file.second.reserved.clear();
+		//Buforowane dane s po prostu odrzucane
+		if (file.second.delayed) { DISK.FAT.delayedSpace -= CountDataBlocks(file.second.buffer) * BLOCK_SIZE; }
+		ChangeFileStatistics(file.second, false);
+		paths.push_back(path + '/' + file.first);
+	}
+	for (auto &subDirectory : directory.subDirectories) {
+		paths.push_back(path + '/' + subDirectory.first);
+		CollectDirectory(subDirectory.second, path + '/' + subDirectory.first, blocks, paths);
+	}
+}
+
+const bool FileManager::CheckIfContainsSwap(Directory &directory) {
+	LoadDirectory(directory);
+	for (const auto &file : directory.files) {
+		if (file.second.swap) { return true; }
+	}
+	for (auto &subDirectory : directory.subDirectories) {
+		if (CheckIfContainsSwap(subDirectory.second)) { return true; }
+	}
+	return false;
+}
+
+const bool FileManager::FlushDirectory(Directory &directory) {
+	//Niepowodzenie jednego pliku nie wstrzymuje oprniania pozostaych
+	bool flushed = true;
+	//FileFlush dziaa w obecnym katalogu
+	Directory* previousDirectory = currentDirectory;
+	currentDirectory = &directory;
+	for (auto &file : directory.files) {
+		if (file.second.delayed && !FileFlush(file.first)) { flushed = false; }
+	}
+	currentDirectory = previousDirectory;
+	//Niewczytane katalogi pochodz z obrazu dysku, wic nie maj buforowanych plikw
+	for (auto &subDirectory : directory.subDirectories) {
+		if (subDirectory.second.loaded && !FlushDirectory(subDirectory.second)) { flushed = false; }
+	}
+	return flushed;
+}
+
+const unsigned int FileManager::CountDataBlocks(const std::string &data) {
+	unsigned int blockCount = 0;
+	for (const std::string &fragment : DataToDataFragments(data)) {
+		if (!CheckIfBlockEmpty(fragment)) { blockCount++; }
+	}
+	return blockCount;
+}
+
+void FileManager::ReleaseReservation(File &file) {
+	for (const unsigned int &block : file.reserved) { ChangeBitVectorValue(block, 0); }
+	DISK.FAT.reservedSpace -= file.reserved.size() * BLOCK_SIZE;
+	file.reserved.clear();
+}
+
+void FileManager::ChangeFileStatistics(const File &file, const bool &add) {
+	//Udzia pliku w statystykach dodawany (+1) lub odejmowany (-1)
+	const int sign = add ? 1 : -1;
+	DISK.FAT.fileCount += sign;
+	DISK.FAT.fragmentCount += sign * (int)file.fragments;
+	if (file.fragments <= 1) { DISK.FAT.contiguousFileCount += sign; }
+}
+
+const bool FileManager::WriteBlocks(File &file, const unsigned int &offset, const std::vector<WriteBuffer> &buffers) {
+	//Pooenie pocztku kadego bufora w zapisywanych danych
+	const std::vector<size_t> starts = BufferStarts(buffers);
+	//Koniec zapisywanego obszaru
+	const unsigned int end = offset + starts.back();
+
+	//Bloki pliku (rozszerzone o nowe bloki logiczne, ktre pocztkowo s dziurami)
+	std::vector<unsigned int> blocks = GetFileBlocks(file);
+	//Liczba blokw logicznych przed zapisem
+	const unsigned int oldBlockCount = blocks.size();
+	if (end > blocks.size()*BLOCK_SIZE) {
+		blocks.resize((unsigned int)ceil((double)end / (double)BLOCK_SIZE), -1);
+	}
+	//Nowe bloki logiczne dostaj najpierw bloki zarezerwowane dla pliku
+	const unsigned int reservedUsed = std::min(blocks.size() - oldBlockCount, file.reserved.size());
+	for (unsigned int i = 0; i < reservedUsed; i++) { blocks[oldBlockCount + i] = file.reserved[i]; }
+
+	//Pierwszy i ostatni (wycznie) blok logiczny objty zapisem
+	const unsigned int firstBlock = offset / BLOCK_SIZE;
+	const unsigned int lastBlock = end == offset ? firstBlock : (end - 1) / BLOCK_SIZE + 1;
+
+	//Czci buforw przypadajce na blok logiczny
+	const auto blockPieces = [&](const unsigned int &i) {
+		const unsigned int begin = std::max(offset, i*BLOCK_SIZE);
+		const unsigned int stop = std::min(end, (i + 1)*BLOCK_SIZE);
+		return SliceBuffers(buffers, starts, begin - offset, stop - begin);
+	};
+
+	//Liczba dziur, ktre trzeba zaalokowa (dziura, do ktrej trafiaj same zera, pozostaje dziur)
+	unsigned int neededBlocks = 0;
+	for (unsigned int i = firstBlock; i < lastBlock; i++) {
+		if (blocks[i] == -1 && !CheckIfBuffersEmpty(blockPieces(i))) { neededBlocks++; }
+	}
+	//Jeli dziury do zaalokowania si nie zmieszcz
+	if (!CheckIfEnoughSpace(neededBlocks*BLOCK_SIZE)) {
+		std::cout << "Za mao miejsca!\n";
+		return false;
+	}
+
+	//Leniwa alokacja - bloki dostaj tylko dziury, do ktrych trafiy niezerowe dane
+	std::vector<unsigned int> newBlocks;
+	if (neededBlocks > 0) { newBlocks = FindUnallocatedBlocks(neededBlocks); }
+	unsigned int newBlockIndex = 0;
+
+	//Zera dopeniajce bloki bez poprzedniej zawartoci
+	static const char zeros[BLOCK_SIZE] = {};
+	//Czci buforw zapisywane jedn operacj dysku (cigy obszar blokw fizycznych)
+	std::vector<WriteBuffer> run;
+	unsigned int runBegin = 0, runEnd = 0;
+	const auto writeRun = [&] {
+		if (!run.empty()) { DISK.write(runBegin, run); }
+		run.clear();
+	};
+
+	for (unsigned int i = firstBlock; i < lastBlock; i++) {
+		std::vector<WriteBuffer> pieces = blockPieces(i);
+		//Blok bez poprzedniej zawartoci (nowo zaalokowana dziura lub niezapisany blok zarezerwowany)
+		bool fresh = i >= oldBlockCount;
+		if (blocks[i] == -1) {
+			//Zera zapisane w dziurze nie wymagaj alokacji
+			if (CheckIfBuffersEmpty(pieces)) { writeRun(); continue; }
+			blocks[i] = newBlocks[newBlockIndex++];
+			ChangeBitVectorValue(blocks[i], 1);
+			fresh = true;
+		}
+
+		const unsigned int begin = std::max(offset, i*BLOCK_SIZE);
+		const unsigned int stop = std::min(end, (i + 1)*BLOCK_SIZE);
+		//Czciowo zapisywany blok z zawartoci zachowuje reszt danych, nowy blok dopeniany jest zerami
+		if (fresh) {
+			if (begin > i*BLOCK_SIZE) { pieces.insert(pieces.begin(), WriteBuffer{ zeros, begin - i * BLOCK_SIZE }); }
+			if (stop < (i + 1)*BLOCK_SIZE) { pieces.push_back(WriteBuffer{ zeros, (i + 1)*BLOCK_SIZE - stop }); }
+		}
+		const unsigned int address = blocks[i] * BLOCK_SIZE + (fresh ? 0 : begin - i * BLOCK_SIZE);
+		const unsigned int length = fresh ? BLOCK_SIZE : stop - begin;
+
+		if (run.empty() || address != runEnd) {
+			writeRun();
+			runBegin = address;
+			runEnd = address;
+		}
+		run.insert(run.end(), pieces.begin(), pieces.end());
+		runEnd += length;
+	}
+	writeRun();
+
+	//Zarezerwowane bloki midzy starym kocem pliku a zapisem wypeniane s zerami
+	for (unsigned int i = oldBlockCount; i < std::min(firstBlock, oldBlockCount + reservedUsed); i++) {
+		DISK.write(blocks[i] * BLOCK_SIZE, (blocks[i] + 1)*BLOCK_SIZE - 1, std::string(BLOCK_SIZE, '\0'));
+	}
+	//Wykorzystane bloki przestaj by rezerwacj
+	file.reserved.erase(file.reserved.begin(), file.reserved.begin() + reservedUsed);
+	DISK.FAT.reservedSpace -= reservedUsed * BLOCK_SIZE;
+
+	//Aktualizacja rozmiarw pliku
+	file.size = blocks.size()*BLOCK_SIZE;
+	file.sizeOnDisk = std::max((unsigned int)file.sizeOnDisk, end);
+	//Zapisywanie daty modyfikacji pliku
+	file.modificationTime = GetCurrentTimeAndDate();
+	//Przebudowanie acucha w tablicy FAT
+	LinkFileBlocks(file, blocks);
+	return true;
+}
+
+template<typename Buffer>
+const std::vector<size_t> FileManager::BufferStarts(const std::vector<Buffer> &buffers) {
+	std::vector<size_t> starts(1, 0);
+	for (const Buffer &buffer : buffers) { starts.push_back(starts.back() + buffer.length); }
+	return starts;
+}
+
+template<typename Buffer>
+const std::vector<Buffer> FileManager::SliceBuffers(const std::vector<Buffer> &buffers, const std::vector<size_t> &starts, const size_t &from, const size_t &length) {
+	std::vector<Buffer> pieces;
+	//Ostatni bufor zaczynajcy si nie dalej ni pocztek przedziau
+	size_t buffer = std::upper_bound(starts.begin(), starts.end(), from) - starts.begin() - 1;
+	for (size_t position = from; position < from + length; buffer++) {
+		const size_t skip = position - starts[buffer];
+		const size_t take = std::min(buffers[buffer].length - skip, from + length - position);
+		if (take > 0) { pieces.push_back(Buffer{ buffers[buffer].data + skip, take }); }
+		position += take;
+	}
+	return pieces;
+}
+
+const bool FileManager::CheckIfBuffersEmpty(const std::vector<WriteBuffer> &buffers) {
+	for (const WriteBuffer &buffer : buffers) {
+		for (size_t i = 0; i < buffer.length; i++) {
+			if (buffer.data[i] != '\0') { return false; }
+		}
+	}
+	return true;
+}
+
+void FileManager::CopyBuffers(std::string &content, const unsigned int &offset, const std::vector<WriteBuffer> &buffers) {
+	unsigned int position = offset;
+	for (const WriteBuffer &buffer : buffers) {
+		if (content.size() < position + buffer.length) { content.resize(position + buffer.length, '\0'); }
+		content.replace(position, buffer.length, buffer.data, buffer.length);
+		position += buffer.length;
+	}
+	if (content.size() < position) { content.resize(position, '\0'); }
+}
+
+const std::string FileManager::ReadBlocks(const std::vector<unsigned int> &blocks) {
+	//Dane
+	std::string data;
+	for (unsigned int i = 0; i < blocks.size(); ) {
+		//Dziura odczytywana jest jako zera, bez odwoywania si do dysku
+		if (blocks[i] == -1) {
+			data += std::string(BLOCK_SIZE, '\0');
+			i++;
+			continue;
+		}
+		//Cigy obszar blokw odczytywany jest jedn operacj (na woluminie z wieloma urzdzeniami - rwnolegle)
+		unsigned int length = 1;
+		while (i + length < blocks.size() && blocks[i + length] == blocks[i] + length) { length++; }
+		const std::string run = DISK.read<std::string>(blocks[i] * BLOCK_SIZE, (blocks[i] + length)*BLOCK_SIZE - 1);
+		//Uszkodzony obszar - dane pliku nie s zwracane
+		if (run.empty()) { return ""; }
+		data += run;
+		i += length;
+	}
+	return data;
+}
+
+const std::vector<unsigned int> FileManager::GetFileBlocks(const File &file) {
+	//Indeksy blokw
+	std::vector<unsigned int> blocks;
+	//Obecny indeks w acuchu FAT
 	unsigned int index = file.FATindex;
 
-	//Zapisuje wszystkie dane na dysku
-	for (unsigned int i = 0; i < fileFragments.size(); i++) {
-		//Zapisuje fragment na dysku
-		DISK.write(index * BLOCK_SIZE, index * BLOCK_SIZE + fileFragments[i].size() - 1, fileFragments[i]);
-		//Zmienia warto bloku w wektorze bitowym na zajty
-		ChangeBitVectorValue(index, 1);
-		//Przypisuje do indeksu numer kolejnego bloku
-		index = DISK.FAT.FileAllocationTable[index];
+	for (unsigned int i = 0; i < file.size / BLOCK_SIZE; i++) {
+		//Dziura nie zajmuje pozycji w acuchu
+		if (file.holes.find(i) != file.holes.end()) { blocks.push_back(-1); }
+		else {
+			blocks.push_back(index);
+			//Przypisuje do indeksu numer kolejnego bloku
+			index = DISK.FAT.FileAllocationTable[index];
+		}
+	}
+	return blocks;
+}
+
+void FileManager::LinkFileBlocks(File &file, const std::vector<unsigned int> &blocks) {
+	//Poprzedni zaalokowany blok w acuchu
+	unsigned int previous = -1;
+
+	//Stary udzia pliku w statystykach jest zastpowany nowym
+	ChangeFileStatistics(file, false);
+	file.FATindex = -1;
+	file.holes.clear();
+	file.fragments = 0;
+	for (unsigned int i = 0; i < blocks.size(); i++) {
+		//Zapamitanie pooenia dziury
+		if (blocks[i] == -1) { file.holes.insert(i); continue; }
+
+		//Nowy fragment zaczyna si, jeli blok nie nastpuje bezporednio po poprzednim
+		if (previous == -1 || blocks[i] != previous + 1) { file.fragments++; }
+		//Pierwszy zaalokowany blok jest pocztkiem pliku
+		if (previous == -1) { file.FATindex = blocks[i]; }
+		//Poprzedni blok wskazuje na obecny
+		else { DISK.FAT.FileAllocationTable[previous] = blocks[i]; }
+		previous = blocks[i];
 	}
+	//Ostatni blok wskazuje na nic
+	if (previous != -1) { DISK.FAT.FileAllocationTable[previous] = -1; }
+	ChangeFileStatistics(file, true);
+}
+
+const bool FileManager::CheckIfBlockEmpty(const std::string &fragment) {
+	return std::all_of(fragment.begin(), fragment.end(), [](const char &c) { return c == '\0'; });
 }
 
 const std::vector<std::string> FileManager::DataToDataFragments(const std::string &data) {
@@ -577,6 +2377,7 @@ const std::vector<unsigned int> FileManager::FindUnallocatedBlocksFragmented(uns
 
 	//Szuka wolnych blokw
 	for (unsigned int i = 0; i < DISK.FAT.bitVector.size(); i++) {
+		allocationPolicy->scanCost++;
 		//Jeli blok wolny
 		if (DISK.FAT.bitVector[i] == 0) {
 			//Dodaje indeks bloku
@@ -587,76 +2388,374 @@ const std::vector<unsigned int> FileManager::FindUnallocatedBlocksFragmented(uns
 			if (blockCount == 0) { break; }
 		}
 	}
+	return blockList;
+}
+
+const std::vector<unsigned int> FileManager::FindUnallocatedBlocks(const unsigned int &blockCount) {
+	//Szuka cigego obszaru blokw wybran strategi alokacji
+	std::vector<unsigned int> blockList = allocationPolicy->FindBlocks(DISK.FAT.bitVector, blockCount);
+
+	//Jeli strategia nie znajdzie dopasowa
+	if (blockList.size() == 0) {
+		//Szuka niezaalokowanych blokw, wybierajc pierwsze wolne
+		blockList = FindUnallocatedBlocksFragmented(blockCount);
+	}
+
+	//Dodaje -1, poniewa przy zapisie w tablicy FAT ostatnia pozycja wskazuje na nic (czyli -1)
 	blockList.push_back(-1);
 	return blockList;
 }
 
-const std::vector<unsigned int> FileManager::FindUnallocatedBlocksBestFit(const unsigned int &blockCount) {
-	//Lista indeksw blokw (dopasowanie)
+const std::vector<unsigned int> FileManager::FindContiguousBlocks(const unsigned int &blockCount) {
 	std::vector<unsigned int> blockList;
-	//Najlepsze dopasowanie
-	std::vector<unsigned int> bestBlockList(DISK.FAT.bitVector.size() + 1);
+	//Najmniejsza dugo wolnego obszaru, ktra mieci potrzebne bloki
+	const auto length = DISK.FAT.freeExtentLengths.lower_bound(blockCount);
+	if (blockCount == 0 || length == DISK.FAT.freeExtentLengths.end()) { return blockList; }
+
+	for (const auto &extent : DISK.FAT.freeExtents) {
+		if (extent.second == *length) {
+			for (unsigned int i = 0; i < blockCount; i++) { blockList.push_back(extent.first + i); }
+			break;
+		}
+	}
+	return blockList;
+}
 
-	//Szukanie wolnych blokw speniajcych minimum miejsca
-	for (unsigned int i = 0; i < DISK.FAT.bitVector.size(); i++) {
-		//Jeli blok wolny
-		if (DISK.FAT.bitVector[i] == 0) {
-			//Dodaj indeks bloku do listy blokw
-			blockList.push_back(i);
+FileManager::File* FileManager::FindFile(const std::string &path) {
+	//Plik ley w katalogu wskazanym przez cz cieki przed ostatnim znakiem '/'
+	const size_t slash = path.rfind('/');
+	if (slash == std::string::npos || slash == 0) { return nullptr; }
+	Directory* directory = FindDirectory(path.substr(0, slash));
+	if (directory == nullptr) { return nullptr; }
+	auto fileIterator = directory->files.find(path.substr(slash + 1));
+	return fileIterator == directory->files.end() ? nullptr : &fileIterator->second;
+}
+
+FileManager::Directory* FileManager::FindDirectory(const std::string &path) {
+	//Czci cieki oddzielone znakiem '/'
+	std::vector<std::string> parts;
+	for (size_t begin = 1, end; begin <= path.size(); begin = end + 1) {
+		end = path.find('/', begin);
+		if (end == std::string::npos) { end = path.size(); }
+		parts.push_back(path.substr(begin, end - begin));
+	}
+	if (path.empty() || path[0] != '/' || parts.empty() || parts[0] != DISK.FAT.rootDirectory.name) { return nullptr; }
+
+	Directory* directory = &DISK.FAT.rootDirectory;
+	for (size_t i = 1; i < parts.size(); i++) {
+		LoadDirectory(*directory);
+		auto dir = directory->subDirectories.find(parts[i]);
+		if (dir == directory->subDirectories.end()) { return nullptr; }
+		directory = &dir->second;
+	}
+	LoadDirectory(*directory);
+	return directory;
+}
+
+const std::vector<std::string> FileManager::ReadOpenFileBlocks(const File &file, OpenFile &openFile, const unsigned int &first, const unsigned int &count) {
+	//Kursor w acuchu FAT przesuwa si tylko do przodu, cofnicie zaczyna od pocztku pliku
+	if (openFile.cursorIndex == -1 || first < openFile.cursorBlock) {
+		openFile.cursorBlock = 0;
+		openFile.cursorIndex = file.FATindex;
+	}
+	//Dziury nie zajmuj pozycji w acuchu
+	while (openFile.cursorBlock < first) {
+		if (file.holes.find(openFile.cursorBlock) == file.holes.end()) {
+			openFile.cursorIndex = DISK.FAT.FileAllocationTable[openFile.cursorIndex];
 		}
-		//Jeli blok zajty
+		openFile.cursorBlock++;
+	}
+
+	std::vector<std::string> fragments;
+	//Czy ktry obszar by uszkodzony
+	bool corrupt = false;
+	//Pocztek i dugo cigego obszaru, ktry zostanie odczytany jednym odwoaniem do dysku
+	unsigned int runStart = -1;
+	unsigned int runLength = 0;
+	const auto flushRun = [&]() {
+		if (runLength == 0) { return; }
+		const std::string data = DISK.read<std::string>(runStart*BLOCK_SIZE, (runStart + runLength)*BLOCK_SIZE - 1);
+		if (data.empty()) { corrupt = true; }
 		else {
-			//Jeli uzyskana lista blokw jest wiksza od iloci blokw jak chcemy uzyska
-			//to dodaj uzyskane dopasowanie do listy dopasowa;
-			if (blockList.size() >= blockCount) {
-				//Jeli znalezione dopasowanie mniejsze ni najlepsze dopasowanie
-				if (blockList.size() < bestBlockList.size()) {
-					//Przypisanie nowego najlepszego dopasowania
-					bestBlockList = blockList;
-				}
-			}
+			for (unsigned int i = 0; i < runLength; i++) { fragments.push_back(data.substr(i*BLOCK_SIZE, BLOCK_SIZE)); }
+		}
+		readAheadStatistics.deviceReads++;
+		runLength = 0;
+	};
+
+	for (unsigned int i = 0; i < count; i++) {
+		if (file.holes.find(openFile.cursorBlock) != file.holes.end()) {
+			flushRun();
+			fragments.push_back(std::string(BLOCK_SIZE, '\0'));
+		}
+		else {
+			if (runLength > 0 && openFile.cursorIndex != runStart + runLength) { flushRun(); }
+			if (runLength == 0) { runStart = openFile.cursorIndex; }
+			runLength++;
+			openFile.cursorIndex = DISK.FAT.FileAllocationTable[openFile.cursorIndex];
+		}
+		openFile.cursorBlock++;
+	}
+	flushRun();
+	//Uszkodzone bloki - aden fragment nie jest zwracany
+	if (corrupt) { fragments.clear(); }
+	return fragments;
+}
 
-			//Czyci list blokw, aby mona przygotowa kolejne dopasowanie
-			blockList.clear();
+void FileManager::OpenFileInvalidate(const std::string &path) {
+	auto openIterator = openFiles.find(path);
+	if (openIterator == openFiles.end()) { return; }
+	readAheadStatistics.wastedBlocks += openIterator->second.readAhead.size();
+	openIterator->second.readAhead.clear();
+	openIterator->second.cursorIndex = -1;
+}
+
+FileManager::File* FileManager::GetSwapFile() {
+	auto fileIterator = DISK.FAT.rootDirectory.files.find(SWAP_FILE_NAME);
+	if (fileIterator == DISK.FAT.rootDirectory.files.end() || !fileIterator->second.swap) { return nullptr; }
+	return &fileIterator->second;
+}
+
+const unsigned int FileManager::CalculateLargestFreeExtent() {
+	//Dugoci wolnych obszarw s posortowane, najwiksza jest na kocu
+	return DISK.FAT.freeExtentLengths.empty() ? 0 : *DISK.FAT.freeExtentLengths.rbegin();
+}
+
+void FileManager::LoadDirectory(Directory &directory) {
+	if (directory.loaded) { return; }
+	directory.loaded = true;
+
+	std::ifstream image(imagePath, std::ios::binary);
+	image.seekg(directory.imageOffset);
+
+	directory.creationTime = ReadTime(image);
+	const unsigned int fileCount = ReadNumber(image, 2);
+	const unsigned int subDirectoryCount = ReadNumber(image, 2);
+
+	//Wpisy plikw
+	for (unsigned int i = 0; i < fileCount; i++) {
+		File file(ReadString(image));
+		const unsigned int flags = ReadNumber(image, 1);
+		file.inlined = flags & 1;
+		file.swap = (flags & 2) != 0;
+		file.size = ReadNumber(image, 4);
+		file.sizeOnDisk = ReadNumber(image, 4);
+		file.FATindex = ReadNumber(image, 2);
+		if (file.FATindex == 0xFFFF) { file.FATindex = -1; }
+		file.fragments = ReadNumber(image, 2);
+		file.creationTime = ReadTime(image);
+		file.modificationTime = ReadTime(image);
+		file.creator = ReadString(image);
+		file.inlineData = ReadString(image);
+		const unsigned int holeCount = ReadNumber(image, 2);
+		for (unsigned int hole = 0; hole < holeCount; hole++) {
+			file.holes.insert(file.holes.end(), ReadNumber(image, 4));
+		}
+		if (flags & 4) {
+			const unsigned int reservedCount = ReadNumber(image, 2);
+			for (unsigned int block = 0; block < reservedCount; block++) { file.reserved.push_back(ReadNumber(image, 2)); }
 		}
+		directory.files[file.name] = file;
 	}
 
-	/*
-	Jeli zdarzy si, e ostatni blok w wektorze bitowym jest wolny, to
-	ostatnie dopasownie nie zostanie dodane do listy dopasowa, dlatego
-	trzeba wykona poniszy kod. Jeli ostatni blok w wektorze bitowym
-	bdzie zajty to blockList bdzie pusty i nie spieni warunku
-	*/
-	if (blockList.size() >= blockCount) {
-		//Jeli blok wolny
-		if (blockList.size() < bestBlockList.size()) {
-			//Dodaj indeks bloku do listy blokw
-			bestBlockList = blockList;
+	//Wpisy podkatalogw - tylko nazwa i pooenie rekordu
+	for (unsigned int i = 0; i < subDirectoryCount; i++) {
+		const std::string name = ReadString(image);
+		Directory &subDirectory = directory.subDirectories[name] = Directory(name, &directory);
+		subDirectory.loaded = false;
+		subDirectory.imageOffset = ReadNumber(image, 4);
+	}
+
+	if (!image) { std::cout << "Bd odczytu katalogu '" << directory.name << "' z obrazu '" << imagePath << "'!\n"; }
+}
+
+void FileManager::LoadAllDirectories(Directory &directory) {
+	LoadDirectory(directory);
+	for (auto &subDirectory : directory.subDirectories) { LoadAllDirectories(subDirectory.second); }
+}
+
+const unsigned int FileManager::AppendDirectoryRecord(std::string &image, Directory &directory) {
+	//Rekordy podkatalogw musz by zapisane wczeniej, eby zna ich pooenie
+	std::vector<std::pair<std::string, unsigned int>> subDirectoryOffsets;
+	for (auto &dir : directory.subDirectories) {
+		subDirectoryOffsets.push_back({ dir.first, AppendDirectoryRecord(image, dir.second) });
+	}
+
+	const unsigned int offset = image.size();
+	AppendTime(image, directory.creationTime);
+	AppendNumber(image, directory.files.size(), 2);
+	AppendNumber(image, directory.subDirectories.size(), 2);
+
+	for (const auto &entry : directory.files) {
+		const File &file = entry.second;
+		AppendString(image, file.name);
+		AppendNumber(image, (file.inlined ? 1 : 0) | (file.swap ? 2 : 0) | (file.reserved.empty() ? 0 : 4), 1);
+		AppendNumber(image, file.size, 4);
+		AppendNumber(image, file.sizeOnDisk, 4);
+		AppendNumber(image, file.FATindex == -1 ? 0xFFFF : file.FATindex, 2);
+		AppendNumber(image, file.fragments, 2);
+		AppendTime(image, file.creationTime);
+		AppendTime(image, file.modificationTime);
+		AppendString(image, file.creator);
+		AppendString(image, file.inlineData);
+		AppendNumber(image, file.holes.size(), 2);
+		for (const unsigned int &hole : file.holes) { AppendNumber(image, hole, 4); }
+		if (!file.reserved.empty()) {
+			AppendNumber(image, file.reserved.size(), 2);
+			for (const unsigned int &block : file.reserved) { AppendNumber(image, block, 2); }
 		}
 	}
 
-	//Jeli znalezione najlepsze dopasowanie
-	if(bestBlockList.size() < DISK.FAT.bitVector.size() + 1){
-		//Odetnij nadmiarowe indeksy z dopasowania (jeli wiksze ni potrzeba)
-		bestBlockList.resize(blockCount);
+	for (const auto &subDirectory : subDirectoryOffsets) {
+		AppendString(image, subDirectory.first);
+		AppendNumber(image, subDirectory.second, 4);
 	}
-	//Inaczej zmniejsz dopasowanie do 0, eby po zwrceniu wybrano inn metod
-	else { bestBlockList.resize(0); }
+	return offset;
+}
 
-	return bestBlockList;
+void FileManager::AppendNumber(std::string &buffer, const unsigned int &value, const unsigned int &bytes) {
+	for (unsigned int i = 0; i < bytes; i++) {
+		buffer += (char)((value >> (8 * i)) & 0xFF);
+	}
 }
 
-const std::vector<unsigned int> FileManager::FindUnallocatedBlocks(const unsigned int &blockCount) {
-	//Szuka blokw funkcj z metod best-fit
-	std::vector<unsigned int> blockList = FindUnallocatedBlocksBestFit(blockCount);
+const unsigned int FileManager::ReadNumber(std::istream &stream, const unsigned int &bytes) {
+	unsigned int value = 0;
+	for (unsigned int i = 0; i < bytes; i++) {
+		value |= (unsigned int)(unsigned char)stream.get() << (8 * i);
+	}
+	return value;
+}
 
-	//Jeli funkcja z metod best-fit nie znajdzie dopasowa
-	if (blockList.size() == 0) {
-		//Szuka niezaalokowanych blokw, wybierajc pierwsze wolne
-		blockList = FindUnallocatedBlocksFragmented(blockCount);
+void FileManager::AppendString(std::string &buffer, const std::string &text) {
+	AppendNumber(buffer, text.size(), 1);
+	buffer += text;
+}
+
+const std::string FileManager::ReadString(std::istream &stream) {
+	std::string text(ReadNumber(stream, 1), '\0');
+	stream.read(&text[0], text.size());
+	return text;
+}
+
+void FileManager::AppendTime(std::string &buffer, const tm &time) {
+	AppendNumber(buffer, time.tm_year, 2);
+	AppendNumber(buffer, time.tm_mon, 1);
+	AppendNumber(buffer, time.tm_mday, 1);
+	AppendNumber(buffer, time.tm_hour, 1);
+	AppendNumber(buffer, time.tm_min, 1);
+	AppendNumber(buffer, time.tm_sec, 1);
+}
+
+const tm FileManager::ReadTime(std::istream &stream) {
+	tm time{};
+	time.tm_year = ReadNumber(stream, 2);
+	time.tm_mon = ReadNumber(stream, 1);
+	time.tm_mday = ReadNumber(stream, 1);
+	time.tm_hour = ReadNumber(stream, 1);
+	time.tm_min = ReadNumber(stream, 1);
+	time.tm_sec = ReadNumber(stream, 1);
+	return time;
+}
+
+void FileManager::CollectFiles(Directory &directory, std::vector<File*> &files) {
+	LoadDirectory(directory);
+	for (auto &file : directory.files) { files.push_back(&file.second); }
+	for (auto &dir : directory.subDirectories) { CollectFiles(dir.second, files); }
+}
+
+void FileManager::RebuildStatistics() {
+	//Wolne miejsce i wolne obszary
+	DISK.FAT.freeSpace = 0;
+	DISK.FAT.reservedSpace = 0;
+	for (Disk::Device &device : DISK.devices) { device.freeSpace = 0; }
+	DISK.FAT.freeExtents.clear();
+	DISK.FAT.freeExtentLengths.clear();
+	DISK.FAT.freeExtentHistogram.fill(0);
+	//Dugo obecnie przegldanego wolnego obszaru
+	unsigned int length = 0;
+	for (unsigned int block = 0; block <= DISK.FAT.bitVector.size(); block++) {
+		if (block < DISK.FAT.bitVector.size() && DISK.FAT.bitVector[block] == 0) {
+			DISK.FAT.freeSpace += BLOCK_SIZE;
+			DISK.devices[DISK.DeviceOf(block)].freeSpace += BLOCK_SIZE;
+			length++;
+		}
+		else if (length > 0) {
+			AddFreeExtent(block - length, length);
+			length = 0;
+		}
 	}
 
-	//Dodaje -1, poniewa przy zapisie w tablicy FAT ostatnia pozycja wskazuje na nic (czyli -1)
-	blockList.push_back(-1);
-	return blockList;
+	//Statystyki plikw
+	DISK.FAT.fileCount = 0;
+	DISK.FAT.contiguousFileCount = 0;
+	DISK.FAT.fragmentCount = 0;
+	std::vector<File*> files;
+	CollectFiles(DISK.FAT.rootDirectory, files);
+	for (const File *file : files) {
+		ChangeFileStatistics(*file, true);
+		DISK.FAT.reservedSpace += file->reserved.size() * BLOCK_SIZE;
+	}
+}
+
+const bool FileManager::MatchPattern(const std::string &name, const std::string &pattern) {
+	//Pozycje w nazwie i we wzorcu
+	size_t n = 0, p = 0;
+	//Pozycja ostatniej gwiazdki we wzorcu i pozycja w nazwie, od ktrej j dopasowano
+	size_t star = std::string::npos, starMatch = 0;
+
+	while (n < name.size()) {
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) { n++; p++; }
+		else if (p < pattern.size() && pattern[p] == '*') { star = p++; starMatch = n; }
+		//Niedopasowanie - gwiazdka obejmuje jeden znak wicej
+		else if (star != std::string::npos) { p = star + 1; n = ++starMatch; }
+		else { return false; }
+	}
+	//Pozostae gwiazdki pasuj do pustego cigu
+	while (p < pattern.size() && pattern[p] == '*') { p++; }
+	return p == pattern.size();
+}
+
+const unsigned long long FileManager::TimeToNumber(const tm &time) {
+	return time.tm_year * 10000000000ULL + time.tm_mon * 100000000ULL + time.tm_mday * 1000000ULL
+		+ time.tm_hour * 10000ULL + time.tm_min * 100ULL + time.tm_sec;
+}
+
+void FileManager::NameIndexAdd(const std::string &name, const std::string &path) {
+	if (!nameIndexEnabled) { return; }
+	nameIndex.insert({ name, path });
+	for (size_t i = 0; i < name.size(); i++) { suffixIndex.insert({ name.substr(i), path }); }
+}
+
+void FileManager::NameIndexRemove(const std::string &name, const std::string &path) {
+	if (!nameIndexEnabled) { return; }
+	//Usuwa z indeksu pozycj o podanym kluczu i ciece
+	const auto erase = [&path](std::multimap<std::string, std::string> &index, const std::string &key) {
+		const auto range = index.equal_range(key);
+		for (auto i = range.first; i != range.second; i++) {
+			if (i->second == path) { index.erase(i); return; }
+		}
+	};
+	erase(nameIndex, name);
+	for (size_t i = 0; i < name.size(); i++) { erase(suffixIndex, name.substr(i)); }
+}
+
+void FileManager::NameIndexDirectory(Directory &directory, const std::string &path) {
+	LoadDirectory(directory);
+	for (const auto &file : directory.files) { NameIndexAdd(file.first, path + '/' + file.first); }
+	for (auto &dir : directory.subDirectories) {
+		NameIndexAdd(dir.first, path + '/' + dir.first);
+		NameIndexDirectory(dir.second, path + '/' + dir.first);
+	}
+}
+
+const std::vector<std::string> FileManager::NameIndexRange(const std::multimap<std::string, std::string> &index, const std::string &prefix) {
+	if (!nameIndexEnabled) { std::cout << "Indeks nazw jest wyczony!\n"; }
+	//cieki bez powtrze (nazwa moe zawiera szukany cig kilka razy)
+	std::set<std::string> paths;
+	//Klucze zaczynajce si od przedrostka tworz cigy zakres w posortowanym indeksie
+	for (auto i = index.lower_bound(prefix); i != index.end() && i->first.compare(0, prefix.size(), prefix) == 0; i++) {
+		paths.insert(i->second);
+	}
+	return std::vector<std::string>(paths.begin(), paths.end());
 }
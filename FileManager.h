@@ -16,12 +16,19 @@
 #include <array>
 #include <bitset>
 #include <vector>
+#include <set>
+#include <map>
 #include <unordered_map>
 #include <iostream>
+#include <memory>
+#include <fstream>
+#include <functional>
+#include <climits>
+#include "ThreadPool.h"
+#include "Checksum.h"
 
 /*
 	Todo:
-	- otwieranie i zamykanie pliku
 	- plik flagi + dane utworzenia
 	- defragmentator
 	- zapisywanie plikw z kodem asemblerowym
@@ -29,14 +36,63 @@
 
 //Klasa zarzdcy przestrzeni dyskow i systemem plikw
 class FileManager {
+public:
+	//Dostpne strategie alokacji blokw
+	enum class AllocationPolicyType { NextFit, FirstFit, WorstFit, BestFit, AlignedFit };
+
+	//Bufor z danymi do zapisu wektorowego (pami wywoujcego, dane nie s kopiowane do porednich buforw)
+	struct WriteBuffer {
+		const char *data; //Pocztek danych
+		size_t length;    //Dugo danych (bajty)
+	};
+
+	//Bufor na dane odczytu wektorowego (pami wywoujcego)
+	struct ReadBuffer {
+		char *data;    //Pocztek bufora
+		size_t length; //Dugo bufora (bajty)
+	};
+
 private:
 	//--------------- Definicje staych statycznych -------------
 	static const unsigned int BLOCK_SIZE = 8;   //Stay rozmiar bloku (bajty)
 	static const size_t DISK_CAPACITY = 1024;   //Staa pojemno dysku (bajty)
+	static const unsigned int EXTENT_HISTOGRAM_SIZE = 8; //Liczba przedziaw histogramu wolnych obszarw (log2(liczba blokw) + 1)
+	static const unsigned int MAX_READ_AHEAD = 8;        //Najwiksze okno odczytu z wyprzedzeniem (bloki)
+	static const unsigned int DEVICE_ACCESS_COST = 8;    //Koszt rozpoczcia operacji na urzdzeniu (przygotowanie i wyszukanie)
+	static const unsigned int DEVICE_TRANSFER_COST = 1;  //Koszt przesania jednego bloku z lub na urzdzenie
+
+	//------------- Definicje staych formatu obrazu ------------
+	/*
+		Ukad obrazu dysku (liczby zapisywane little-endian):
+		- superblok (SUPERBLOCK_SIZE bajtw):
+		  magic (4), wersja (2), rozmiar bloku (2), liczba blokw (4), wolne miejsce (4),
+		  pooenie tablicy FAT (4), wektora bitowego (4), danych (4), katalogu gwnego (4),
+		  liczba plikw (4), liczba plikw cigych (4), liczba fragmentw (4),
+		  liczba urzdze woluminu (4, 0 oznacza jedno urzdzenie), zarezerwowane miejsce (4),
+		  pooenie sum kontrolnych (4, 0 - brak, sumy liczone s przy montowaniu), reszta zarezerwowana
+		- tablica FAT: 2 bajty na blok, 0xFFFF oznacza koniec acucha
+		- wektor bitowy: 1 bit na blok
+		- sumy kontrolne: CRC32C kadego bloku (4 bajty na blok)
+		- dane: DISK_CAPACITY bajtw przestrzeni dyskowej w kolejnoci blokw woluminu
+		- rekordy katalogw zapisane od najgbszych, katalog gwny na kocu:
+		  data utworzenia (7), liczba plikw (2), liczba podkatalogw (2), wpisy plikw, wpisy podkatalogw
+		  wpis pliku: nazwa (1 + n), flagi (1: bit 0 - plik wewntrzny, bit 1 - plik wymiany, bit 2 - rezerwacja),
+		              rozmiar (4), rozmiar rzeczywisty (4), indeks FAT (2),
+		              liczba fragmentw (2), data utworzenia (7), data modyfikacji (7), twrca (1 + n),
+		              dane wewntrzne (1 + n), liczba dziur (2), numery dziur (4 kada),
+		              tylko z rezerwacj: liczba zarezerwowanych blokw (2), numery blokw (2 kady)
+		  wpis podkatalogu: nazwa (1 + n), pooenie rekordu podkatalogu (4)
+		Data zapisywana jest jako rok (2), miesic, dzie, godzina, minuta, sekunda (po 1).
+	*/
+	static const unsigned int IMAGE_MAGIC = 0x53465853; //"SXFS"
+	static const unsigned int IMAGE_VERSION = 1;        //Wersja formatu obrazu
+	static const unsigned int SUPERBLOCK_SIZE = 64;     //Rozmiar superbloku (bajty)
 
 	//--------------------- Definicje staych -------------------
 	const size_t MAX_PATH_LENGTH = 32;   //Maksymalna dugo cieki
 	const size_t MAX_DIRECTORY_ELEMENTS = 24; //Maksymalna ilo elementw w katalogu
+	const size_t MAX_INLINE_SIZE = BLOCK_SIZE; //Maksymalny rozmiar pliku przechowywanego we wpisie katalogu
+	const std::string SWAP_FILE_NAME = "swap"; //Nazwa pliku wymiany w katalogu gwnym
 
 	//---------------- Definicje struktur i klas ----------------
 
@@ -47,6 +103,21 @@ private:
 		size_t size;	   //Rozmiar pliku
 		size_t sizeOnDisk; //Rozmiar pliku na dysku
 		unsigned int FATindex; //Indeks pozycji pocztku pliku w tablicy FAT
+		std::set<unsigned int> holes; //Numery blokw logicznych bdcych dziurami (nie zajmuj miejsca na dysku)
+		unsigned int fragments = 0; //Liczba cigych obszarw blokw zajmowanych przez plik
+		//Bloki zarezerwowane dla kolejnych blokw logicznych za kocem pliku (zajte, ale jeszcze niezapisane)
+		std::vector<unsigned int> reserved;
+
+		//Dane maych plikw
+		bool inlined = false;   //Czy dane pliku s przechowywane we wpisie katalogu zamiast w blokach
+		std::string inlineData; //Dane pliku przechowywane we wpisie katalogu
+
+		//Opniona alokacja
+		bool delayed = false; //Czy dane pliku czekaj w pamici na wybr blokw (plik nie ma jeszcze blokw)
+		std::string buffer;   //Dane pliku czekajce na zapisanie na dysku
+
+		//Plik wymiany
+		bool swap = false; //Czy plik jest plikiem wymiany zarzdcy pamici (cigy, nie moe by zmieniany)
 
 		//Dodatkowe informacje
 		tm creationTime;	 //Czas i data utworzenia pliku
@@ -69,7 +140,7 @@ private:
 	//Struktura katalogu
 	struct Directory {
 		std::string name;  //Nazwa katalogu
-		tm creationTime;   //Czas i data utworzenia katalogu
+		tm creationTime{}; //Czas i data utworzenia katalogu
 		//size_t size;	   //Rozmiar katalogu
 		//size_t sizeOnDisk; //Rozmiar katalogu na dysku
 		//unsigned int folderCount; //Liczba katalogw w tym katalogu
@@ -80,6 +151,10 @@ private:
 		std::unordered_map<std::string, Directory>subDirectories; //Tablica hashowa podkatalogw
 		Directory* parentDirectory; //Wskanik na katalog nadrzdny
 
+		//Leniwe wczytywanie zamontowanego obrazu
+		bool loaded = true;           //Czy zawarto katalogu zostaa wczytana z obrazu dysku
+		unsigned int imageOffset = 0; //Pooenie rekordu katalogu w obrazie dysku
+
 		/**
 			Konstruktor domylny.
 		*/
@@ -94,13 +169,102 @@ private:
 		Directory(const std::string &name_, Directory* parentDirectory_) : name(name_), parentDirectory(parentDirectory_) {}
 	};
 
+	//Wektor bitowy blokw (0 - wolny blok, 1 - zajty blok)
+	typedef std::bitset<DISK_CAPACITY / BLOCK_SIZE> BitVector;
+
+	//Otwarty plik
+	struct OpenFile {
+		unsigned int position = 0; //Pozycja, od ktrej nastpi nastpny odczyt (bajty)
+
+		//Kursor acucha FAT - kolejny odczyt sekwencyjny nie przechodzi acucha od pocztku
+		unsigned int cursorBlock = 0;  //Blok logiczny wskazywany przez kursor
+		unsigned int cursorIndex = -1; //Pierwszy zaalokowany blok fizyczny od bloku cursorBlock (-1 - kursor nieustawiony)
+
+		//Odczyt z wyprzedzeniem
+		unsigned int window = 1;                       //Liczba blokw odczytywanych z wyprzedzeniem (0 - dostp losowy)
+		std::map<unsigned int, std::string> readAhead; //Bloki odczytane z wyprzedzeniem (blok logiczny -> dane)
+	};
+
+	//Statystyki odczytu otwartych plikw
+	struct ReadAheadStatistics {
+		unsigned long long requestedBlocks = 0; //Liczba blokw, ktrych dotyczyy odczyty
+		unsigned long long readAheadHits = 0;   //Liczba blokw dostarczonych z odczytu z wyprzedzeniem
+		unsigned long long readAheadBlocks = 0; //Liczba blokw odczytanych z wyprzedzeniem
+		unsigned long long wastedBlocks = 0;    //Liczba blokw odczytanych z wyprzedzeniem i odrzuconych bez uycia
+		unsigned long long deviceReads = 0;     //Liczba operacji odczytu dysku (cigy obszar blokw - jedna operacja)
+	};
+
+	//Interfejs strategii szukania cigego obszaru wolnych blokw
+	class AllocationPolicy {
+	public:
+		unsigned long long scanCost = 0; //czna liczba blokw sprawdzonych podczas szukania miejsca
+
+		virtual ~AllocationPolicy() = default;
+
+		/**
+			Zwraca nazw strategii.
+
+			@return Nazwa strategii.
+		*/
+		virtual const std::string Name() const = 0;
+
+		/**
+			Szuka cigego obszaru wolnych blokw o podanej dugoci.
+
+			@param bitVector Wektor bitowy dysku.
+			@param blockCount Liczba blokw na jak szukamy miejsca do alokacji.
+			@return Wektor indeksw blokw do zaalokowania lub pusty wektor, jeli nie znaleziono miejsca.
+		*/
+		virtual const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) = 0;
+	};
+
+	//Pierwszy pasujcy obszar liczc od pocztku dysku
+	class FirstFitPolicy : public AllocationPolicy {
+	public:
+		const std::string Name() const override { return "first-fit"; }
+		const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) override;
+	};
+
+	//Pierwszy pasujcy obszar liczc od miejsca ostatniej alokacji
+	class NextFitPolicy : public AllocationPolicy {
+		unsigned int lastPosition = 0; //Indeks bloku, od ktrego rozpocznie si kolejne szukanie
+	public:
+		const std::string Name() const override { return "next-fit"; }
+		const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) override;
+	};
+
+	//Najmniejszy obszar, w ktrym zmieszcz si dane
+	class BestFitPolicy : public AllocationPolicy {
+	public:
+		const std::string Name() const override { return "best-fit"; }
+		const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) override;
+	};
+
+	//Najwikszy wolny obszar
+	class WorstFitPolicy : public AllocationPolicy {
+	public:
+		const std::string Name() const override { return "worst-fit"; }
+		const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) override;
+	};
+
+	/*
+		Pierwszy pasujcy obszar wyrwnany do potgi dwjki. danie zaokrglane jest
+		w gr do potgi dwjki i szukane tylko w obszarach wyrwnanych do tej potgi,
+		ale zajmowane s tylko potrzebne bloki - reszta obszaru zostaje dla innych plikw.
+	*/
+	class AlignedFitPolicy : public AllocationPolicy {
+	public:
+		const std::string Name() const override { return "aligned-fit"; }
+		const std::vector<unsigned int> FindBlocks(const BitVector &bitVector, const unsigned int &blockCount) override;
+	};
+
 	class Disk {
 	public:
 		struct FAT {
 			unsigned int freeSpace{ DISK_CAPACITY }; //Zawiera informacje o iloci wolnego miejsca na dysku (bajty)
 
 			//Wektor bitowy blokw (0 - wolny blok, 1 - zajty blok)
-			std::bitset<DISK_CAPACITY / BLOCK_SIZE> bitVector;
+			BitVector bitVector;
 
 			/*
 			Zawiera indeksy blokw dysku na dysku, na ktrych znajduj si pofragmentowane dane pliku.
@@ -108,22 +272,57 @@ private:
 			*/
 			std::array<unsigned int, DISK_CAPACITY / BLOCK_SIZE>FileAllocationTable;
 
+			//Sumy kontrolne CRC32C blokw, aktualizowane przy kadym zapisie i sprawdzane przy kadym odczycie
+			std::array<unsigned int, DISK_CAPACITY / BLOCK_SIZE> checksums{};
+
 			Directory rootDirectory{ Directory("root", NULL) }; //Katalog gwny
 
+			//Statystyki wolnego miejsca, aktualizowane przy kadej zmianie wektora bitowego
+			std::map<unsigned int, unsigned int> freeExtents; //Wolne obszary (indeks pierwszego bloku -> dugo)
+			std::multiset<unsigned int> freeExtentLengths;    //Dugoci wolnych obszarw (najwikszy na kocu)
+			//Liczba wolnych obszarw o dugoci z przedziau [2^i, 2^(i+1)) blokw
+			std::array<unsigned int, EXTENT_HISTOGRAM_SIZE> freeExtentHistogram{};
+
+			//Statystyki plikw, aktualizowane przy kadej zmianie acucha pliku
+			unsigned int fileCount = 0;           //Liczba plikw na dysku
+			unsigned int contiguousFileCount = 0; //Liczba plikw zajmujcych co najwyej jeden cigy obszar
+			unsigned int fragmentCount = 0;       //czna liczba fragmentw wszystkich plikw
+			unsigned int reservedSpace = 0;       //Miejsce zarezerwowane dla plikw i jeszcze niezapisane (bajty, nie jest wolne)
+			unsigned int delayedSpace = 0;        //Miejsce potrzebne danym czekajcym na opnion alokacj (bajty, jest jeszcze wolne)
+
 			/**
-				Konstruktor domylny. Wykonuje zapenienie tablicy FAT wartoci -1.
+				Konstruktor domylny. Wykonuje zapenienie tablicy FAT wartoci -1
+				i oznacza cay dysk jako jeden wolny obszar.
 			*/
 			FAT();
 		} FAT; //System plikw FAT
 
-		//Tablica reprezentujca przestrze dyskow (jeden indeks - jeden bajt)
-		std::array<char, DISK_CAPACITY> space;
+		/*
+			Urzdzenie woluminu. Wolumin moe skada si z kilku urzdze, kolejne bloki
+			woluminu trafiaj na przemian na kolejne urzdzenia (RAID-0 z paskiem jednego bloku),
+			wic cigy obszar blokw jest rozoony na wszystkie urzdzenia.
+		*/
+		struct Device {
+			std::vector<char> space;          //Przestrze urzdzenia (jeden indeks - jeden bajt)
+			unsigned int freeSpace = 0;       //Wolne miejsce na urzdzeniu (bajty)
+			unsigned long long requests = 0;  //Liczba operacji wykonanych na urzdzeniu
+			unsigned long long blocks = 0;    //Liczba blokw przesanych z lub na urzdzenie
+			unsigned long long busyTime = 0;  //Czas pracy urzdzenia (jednostki kosztu)
+		};
+		std::vector<Device> devices; //Urzdzenia woluminu
+
+		//Czas operacji woluminu - urzdzenia pracuj rwnolegle, wic operacja trwa tyle, co jej najdusza cz
+		unsigned long long elapsedTime = 0;
+		unsigned long long checksumErrors = 0; //Liczba blokw, ktrych suma kontrolna nie zgadzaa si z danymi
 
 		//----------------------- Konstruktor -----------------------
 		/**
-			Konstruktor domylny. Wykonuje zapenienie przestrzeni dyskowej wartoci NULL.
+			Konstruktor. Tworzy wolumin z podanej liczby urzdze i wykonuje
+			zapenienie przestrzeni dyskowej wartoci NULL.
+
+			@param deviceCount Liczba urzdze woluminu.
 		*/
-		Disk();
+		Disk(const unsigned int &deviceCount = 1);
 
 		//-------------------------- Metody -------------------------
 		/**
@@ -145,22 +344,163 @@ private:
 		*/
 		void write(const unsigned int &index, const unsigned int &data);
 
+		/**
+			Zapisuje kolejne bufory na dysku jeden za drugim, od indeksu 'begin'.
+
+			@param begin Indeks od ktrego dane maj by zapisywane.
+			@param buffers Bufory z danymi.
+			@return void.
+		*/
+		void write(const unsigned int &begin, const std::vector<WriteBuffer> &buffers);
+
+		/**
+			Odczytuje dane z dysku od indeksu 'begin' prosto do kolejnych buforw.
+
+			@param begin Indeks od ktrego dane maj by odczytywane.
+			@param buffers Bufory wypeniane po kolei danymi.
+			@return Prawda, jeli sumy kontrolne si zgadzaj, inaczej fasz (bufory nie s wtedy wypeniane).
+		*/
+		const bool read(const unsigned int &begin, const std::vector<ReadBuffer> &buffers);
+
 		/**
 			Odczytuje dane zadanego typu (jeli jest on zaimplementowany) w wskazanym przedziale.
 
 			@param begin Indeks od ktrego dane maj by odczytywane.
 			@param end Indeks do ktrego dane maj by odczytywane.
-			@return zmienna zadanego typu.
+			@return zmienna zadanego typu (pusta, jeli ktry blok ma niezgodn sum kontroln).
 		*/
 		template<typename T>
 		const T read(const unsigned int &begin, const unsigned int &end);
+
+		/**
+			Zwraca bajt woluminu pod wskazanym indeksem (bez liczenia kosztu operacji).
+
+			@param index Indeks bajtu woluminu.
+			@return Referencja do bajtu na urzdzeniu przechowujcym ten bajt.
+		*/
+		char& at(const unsigned int &index);
+
+		/**
+			Zwraca numer urzdzenia przechowujcego blok woluminu.
+
+			@param block Indeks bloku woluminu.
+			@return Numer urzdzenia.
+		*/
+		const unsigned int DeviceOf(const unsigned int &block) const;
+
+		/**
+			Rozkada dane woluminu na now liczb urzdze i przelicza wolne miejsce urzdze.
+
+			@param deviceCount Nowa liczba urzdze.
+			@return void.
+		*/
+		void Stripe(const unsigned int &deviceCount);
+
+		/**
+			Przelicza sumy kontrolne blokw obejmujcych przedzia bajtw woluminu.
+
+			@param begin Indeks pierwszego bajtu.
+			@param end Indeks ostatniego bajtu.
+			@return void.
+		*/
+		void UpdateChecksums(const unsigned int &begin, const unsigned int &end);
+
+		/**
+			Sprawdza sumy kontrolne wszystkich blokw woluminu. Bloki kadego urzdzenia
+			le w pamici jeden za drugim, wic sumy liczone s wsadowo dla caego urzdzenia.
+
+			@return Indeksy blokw z niezgodn sum kontroln (rosnco).
+		*/
+		const std::vector<unsigned int> Scrub();
+
+	private:
+		/**
+			Sprawdza sumy kontrolne blokw obejmujcych przedzia bajtw woluminu
+			i zgasza bloki, ktrych dane zostay uszkodzone.
+
+			@param begin Indeks pierwszego bajtu.
+			@param end Indeks ostatniego bajtu.
+			@return Prawda, jeli sumy kontrolne wszystkich blokw si zgadzaj, inaczej fasz.
+		*/
+		const bool VerifyChecksums(const unsigned int &begin, const unsigned int &end);
+
+		/**
+			Dolicza koszt operacji na przedziale bajtw woluminu. Kade urzdzenie
+			obsuguje swoj cz blokw, czas operacji to czas najduszej czci.
+
+			@param begin Indeks pierwszego bajtu.
+			@param end Indeks ostatniego bajtu.
+			@return void.
+		*/
+		void Account(const unsigned int &begin, const unsigned int &end);
 	} DISK; //Prosta klasa dysku (imitacja fizycznego)
 
 	//------------------- Definicje zmiennych -------------------
 	bool messages = false;
+	bool delayedAllocation = false; //Czy bloki plikw wybierane s dopiero przy oprnieniu bufora
 	Directory* currentDirectory; //Obecnie uytkowany katalog
+	std::unique_ptr<AllocationPolicy> allocationPolicy; //Strategia alokacji blokw uywana na tym dysku
+	std::string imagePath; //cieka obrazu dysku, z ktrego wczytywane s katalogi zamontowanego dysku
+	std::unique_ptr<ThreadPool> threadPool; //Pula wtkw wyszukiwania i sprawdzania dysku (tworzona przy pierwszym uyciu)
+	ReadAheadStatistics readAheadStatistics; //Statystyki odczytu otwartych plikw
+
+	//Indeks nazw plikw i katalogw caego dysku (opcjonalny)
+	bool nameIndexEnabled = false; //Czy indeks jest wczony i aktualizowany
+	std::multimap<std::string, std::string> nameIndex;   //Nazwa -> pena cieka (zapytania o przedrostek)
+	std::multimap<std::string, std::string> suffixIndex; //Kady przyrostek nazwy -> pena cieka (zapytania o podcig)
+
+	std::map<std::string, OpenFile> openFiles; //Tablica otwartych plikw (pena cieka -> otwarty plik)
 
 public:
+	//Raport o fragmentacji dysku i wolnym miejscu
+	struct FragmentationReport {
+		unsigned int freeBlocks;        //Liczba wolnych blokw
+		unsigned int freeExtentCount;   //Liczba wolnych obszarw
+		unsigned int largestFreeExtent; //Dugo najwikszego cigego wolnego obszaru (bloki)
+		//Liczba wolnych obszarw o dugoci z przedziau [2^i, 2^(i+1)) blokw
+		std::array<unsigned int, EXTENT_HISTOGRAM_SIZE> freeExtentHistogram;
+		unsigned int fileCount;           //Liczba plikw
+		unsigned int contiguousFileCount; //Liczba plikw niepodzielonych na fragmenty
+		double fragmentsPerFile;          //rednia liczba fragmentw na plik
+		double contiguousFileShare;       //Udzia plikw niepodzielonych na fragmenty (0 - 1)
+	};
+
+	//Wynik sprawdzania spjnoci systemu plikw
+	struct CheckReport {
+		unsigned int checkedFiles = 0;      //Liczba sprawdzonych plikw
+		unsigned int brokenChains = 0;      //Pliki z acuchem za krtkim, za dugim lub wskazujcym poza dysk
+		unsigned int crossLinkedBlocks = 0; //Bloki nalece do wicej ni jednego acucha
+		unsigned int leakedBlocks = 0;      //Bloki zajte w wektorze bitowym, nienalece do adnego pliku
+		unsigned int unmarkedBlocks = 0;    //Bloki nalece do pliku, oznaczone jako wolne
+		unsigned int strayEntries = 0;      //Wpisy FAT wolnych blokw wskazujce na inny blok
+		unsigned int recordedFreeSpace = 0; //Wolne miejsce zapisane w strukturze FAT (bajty)
+		unsigned int countedFreeSpace = 0;  //Wolne miejsce policzone z wektora bitowego (bajty)
+		bool repaired = false;              //Czy wykonano napraw
+	};
+
+	//Wynik sprawdzania sum kontrolnych caego woluminu
+	struct ScrubReport {
+		unsigned int checkedBlocks = 0;         //Liczba sprawdzonych blokw
+		std::vector<unsigned int> corruptBlocks; //Bloki z niezgodn sum kontroln
+		bool hardwareAccelerated = false;       //Czy sumy liczone byy sprztowo
+	};
+
+	//Kryteria wyszukiwania plikw
+	struct SearchQuery {
+		std::string pattern = "*"; //Wzorzec nazwy pliku (* - dowolny cig znakw, ? - dowolny znak)
+		size_t minSize = 0;        //Minimalny rozmiar rzeczywisty pliku (bajty)
+		size_t maxSize = SIZE_MAX; //Maksymalny rozmiar rzeczywisty pliku (bajty)
+		unsigned long long modifiedAfter = 0;          //Najwczeniejsza data modyfikacji (RRRRMMDDggmmss)
+		unsigned long long modifiedBefore = ULLONG_MAX; //Najpniejsza data modyfikacji (RRRRMMDDggmmss)
+	};
+
+	//Plik znaleziony podczas wyszukiwania
+	struct SearchResult {
+		std::string path;     //Pena cieka pliku
+		size_t size;          //Rozmiar rzeczywisty pliku (bajty)
+		tm modificationTime;  //Czas i data ostatniej modyfikacji pliku
+	};
+
 	//----------------------- Konstruktor -----------------------
 	/**
 		Konstruktor domylny. Przypisuje do obecnego katalogu katalog gwny.
@@ -170,6 +510,9 @@ public:
 	//-------------------- Podstawowe Metody --------------------
 	/**
 		Tworzy plik o podanej nazwie i danych w obecnym katalogu.
+		Dane nie wiksze ni MAX_INLINE_SIZE s przechowywane bezporednio
+		we wpisie katalogu i nie zajmuj blokw na dysku. Przy opnionej
+		alokacji wiksze dane trafiaj do bufora pliku.
 
 		@param name Nazwa pliku
 		@param data Dane typu string.
@@ -177,15 +520,90 @@ public:
 	*/
 	void FileCreate(const std::string &name, const std::string &data);
 
-	//!!!!!!!!!! NIEDOKOCZONE !!!!!!!!!!
 	/**
-		Funkcja niedokoczona.
+		Tworzy plik, ktrego dane s poczeniem podanych buforw (zapis scatter-gather).
+		Bufory przypisywane s bezporednio do blokw pliku, bez sklejania ich w jeden cig.
+
+		@param name Nazwa pliku.
+		@param buffers Bufory z kolejnymi czciami danych.
+		@return void.
+	*/
+	void FileCreateVectored(const std::string &name, const std::vector<WriteBuffer> &buffers);
+
+	/**
+		Otwiera plik o podanej nazwie w obecnym katalogu do odczytu sekwencyjnego.
+		Plik trafia do tablicy otwartych plikw pod pen ciek.
 
 		@param name Nazwa pliku.
-		@return Tymczasowo zwraca dane wczytane z dysku.
+		@return Prawda, jeli plik zosta otwarty, inaczej fasz.
+	*/
+	const bool FileOpen(const std::string &name);
+
+	/**
+		Odczytuje dane otwartego pliku od jego biecej pozycji i przesuwa pozycj.
+		Dopki odczyty nastpuj po sobie, kolejne bloki acucha FAT s odczytywane
+		z wyprzedzeniem, a okno wyprzedzenia ronie dwukrotnie (do MAX_READ_AHEAD).
+		Ssiednie bloki fizyczne odczytywane s jedn operacj dysku.
+
+		@param name Nazwa otwartego pliku w obecnym katalogu.
+		@param length Liczba bajtw do odczytania (przycinana do koca pliku).
+		@return Odczytane dane (pusty cig bez zmiany pozycji, jeli bloki s uszkodzone).
+	*/
+	const std::string FileRead(const std::string &name, const unsigned int &length);
+
+	/**
+		Zmienia pozycj odczytu otwartego pliku. Przeskok w inne miejsce ni
+		bieca pozycja jest dostpem losowym - odczyt z wyprzedzeniem jest
+		wstrzymywany do kolejnego odczytu sekwencyjnego.
+
+		@param name Nazwa otwartego pliku w obecnym katalogu.
+		@param position Nowa pozycja odczytu (bajty).
+		@return void.
 	*/
-	const std::string FileOpen(const std::string &name);
-	//!!!!!!!!!! NIEDOKOCZONE !!!!!!!!!!
+	void FileSeek(const std::string &name, const unsigned int &position);
+
+	/**
+		Zamyka otwarty plik i odrzuca bloki odczytane z wyprzedzeniem.
+		Buforowane dane pliku s zapisywane na dysku.
+
+		@param name Nazwa otwartego pliku w obecnym katalogu.
+		@return void.
+	*/
+	void FileClose(const std::string &name);
+
+	/**
+		Rezerwuje cigy obszar blokw, w ktrym plik bdzie mg urosn do podanego
+		rozmiaru, bez zapisywania danych (jak fallocate z zachowaniem rozmiaru).
+		Rezerwacja zaczyna si bezporednio za plikiem, jeli jest tam miejsce.
+		Dopisywane dane trafiaj najpierw do zarezerwowanych blokw, a zarezerwowane,
+		niezapisane bloki odczytywane s jako zera. Niewykorzystana rezerwacja
+		zwalniana jest przy zamkniciu pliku lub przez FileReleaseReservation.
+
+		@param name Nazwa pliku w obecnym katalogu.
+		@param size Rozmiar pliku, na ktry rezerwowane jest miejsce (bajty).
+		@return void.
+	*/
+	void FileReserve(const std::string &name, const unsigned int &size);
+
+	/**
+		Zwalnia niewykorzystan rezerwacj pliku.
+
+		@param name Nazwa pliku w obecnym katalogu.
+		@return void.
+	*/
+	void FileReleaseReservation(const std::string &name);
+
+	/**
+		Zapisuje na dysku dane pliku buforowane przy opnionej alokacji.
+		Bloki wybierane s dopiero teraz, dla ostatecznego rozmiaru pliku,
+		wic cay plik moe trafi do jednego cigego obszaru.
+
+		Jeli zapis si nie uda (np. brak miejsca), dane zostaj w buforze.
+
+		@param name Nazwa pliku w obecnym katalogu.
+		@return Prawda, jeli bufor zosta zapisany lub by pusty, inaczej fasz.
+	*/
+	const bool FileFlush(const std::string &name);
 
 	/**
 		Wczytuje dane pliku z dysku.
@@ -195,6 +613,33 @@ public:
 	*/
 	const std::string FileGetData(const File &file);
 
+	/**
+		Zapisuje dane w pliku od podanego przesunicia. Jeli zapis wykracza
+		poza koniec pliku, plik jest powikszany, a pominite bloki staj si
+		dziurami. Dziury objte zapisem s alokowane dopiero w tym momencie.
+		Plik przechowywany we wpisie katalogu, ktry przekroczy MAX_INLINE_SIZE,
+		jest przenoszony do blokw na dysku (lub do bufora przy opnionej alokacji).
+		Zapis do pliku buforowanego zmienia tylko bufor.
+
+		@param name Nazwa pliku.
+		@param offset Przesunicie (bajty) od pocztku pliku.
+		@param data Dane typu string.
+		@return void.
+	*/
+	void FileWrite(const std::string &name, const unsigned int &offset, const std::string &data);
+
+	/**
+		Zapisuje w pliku poczenie podanych buforw od podanego przesunicia (jak FileWrite).
+		Kady blok dostaje swoj cz danych prosto z buforw, cige obszary blokw
+		zapisywane s jedn operacj dysku, a czciowo zapisywane bloki nie s odczytywane.
+
+		@param name Nazwa pliku.
+		@param offset Przesunicie (bajty) od pocztku pliku.
+		@param buffers Bufory z kolejnymi czciami danych.
+		@return void.
+	*/
+	void FileWriteVectored(const std::string &name, const unsigned int &offset, const std::vector<WriteBuffer> &buffers);
+
 	/**
 		Usuwa plik o podanej nazwie znajdujcy si w obecnym katalogu.
 		Plik jest wymazywany z tablicy FAT oraz wektora bitowego.
@@ -250,6 +695,25 @@ public:
 	*/
 	void FileRename(const std::string &name, const std::string &changeName);
 
+	/**
+		Przenosi plik z obecnego katalogu do innego katalogu. Zmieniane s tylko
+		wpisy katalogw - bloki danych, rezerwacje i bufor pliku pozostaj na miejscu.
+
+		@param name Nazwa pliku w obecnym katalogu.
+		@param directoryPath Pena cieka katalogu docelowego (np. "/root/katalog").
+		@return void.
+	*/
+	void FileMove(const std::string &name, const std::string &directoryPath);
+
+	/**
+		Usuwa podkatalog obecnego katalogu razem z ca zawartoci. Bloki wszystkich
+		plikw poddrzewa zwalniane s jedn zbiorcz zmian tablicy FAT i wektora bitowego.
+
+		@param name Nazwa podkatalogu.
+		@return void.
+	*/
+	void DirectoryDelete(const std::string &name);
+
 	/**
 		Przechodzi z obecnego katalogu do katalogu gwnego.
 
@@ -257,6 +721,175 @@ public:
 	*/
 	void DirectoryRoot();
 
+	/**
+		Zwraca obecnie uywan ciek.
+
+		@return Obecna cieka z odpowiednim formatowaniem.
+	*/
+	const std::string GetCurrentPath();
+
+	/**
+		Zmienia strategi szukania wolnych blokw uywan na tym dysku.
+
+		@param type Rodzaj strategii alokacji.
+		@return void.
+	*/
+	void SetAllocationPolicy(const AllocationPolicyType &type);
+
+	/**
+		Wcza lub wycza opnion alokacj. Przy wczonej opnionej alokacji
+		tworzone i zapisywane pliki (wiksze ni MAX_INLINE_SIZE) trzymane s
+		w buforze w pamici, a bloki dostaj dopiero przy FileFlush, FileClose,
+		DiskSync lub DiskSave. Plik usunity przed oprnieniem bufora nigdy nie
+		trafia na dysk. Wyczenie opnionej alokacji oprnia wszystkie bufory
+		(jeli ktrego nie da si zapisa, opniona alokacja pozostaje wczona).
+
+		@param enabled Czy opniona alokacja ma by wczona.
+		@return void.
+	*/
+	void SetDelayedAllocation(const bool &enabled);
+
+	/**
+		Zapisuje na dysku buforowane dane wszystkich plikw.
+
+		@return Prawda, jeli zapisano bufory wszystkich plikw, inaczej fasz.
+	*/
+	const bool DiskSync();
+
+	/**
+		Zmienia liczb urzdze, na ktre rozoony jest wolumin. Dane i pliki
+		pozostaj na miejscu, zmienia si tylko przypisanie blokw do urzdze.
+
+		@param count Liczba urzdze (od 1 do liczby blokw).
+		@return void.
+	*/
+	void VolumeSetDevices(const unsigned int &count);
+
+	/**
+		Zapisuje cay system plikw (superblok, tablic FAT, wektor bitowy,
+		dane i rekordy katalogw) do pliku obrazu dysku. Obraz nie jest zapisywany,
+		jeli buforowanych danych ktrego pliku nie da si zapisa na dysku.
+
+		@param path cieka pliku obrazu.
+		@return void.
+	*/
+	void DiskSave(const std::string &path);
+
+	/**
+		Przeszukuje obecny katalog i wszystkie jego podkatalogi. Kady katalog
+		przegldany jest jako osobne zadanie w puli wtkw z podkradaniem zada,
+		wic due poddrzewa rozdzielane s midzy wszystkie rdzenie. Pasujce
+		pliki przekazywane s do funkcji zwrotnej na bieco (wywoania funkcji
+		zwrotnej nie nakadaj si na siebie, kolejno wynikw jest dowolna).
+
+		@param query Kryteria wyszukiwania.
+		@param callback Funkcja wywoywana dla kadego znalezionego pliku.
+		@return void.
+	*/
+	void Search(const SearchQuery &query, const std::function<void(const SearchResult &)> &callback);
+
+	/**
+		Montuje dysk z pliku obrazu. Wczytywane s tylko superblok, tablica FAT,
+		wektor bitowy, dane i katalog gwny, podkatalogi s wczytywane
+		przy pierwszym uyciu.
+
+		@param path cieka pliku obrazu.
+		@return void.
+	*/
+	void DiskMount(const std::string &path);
+
+	/**
+		Zwraca raport o fragmentacji i wolnym miejscu. Statystyki s aktualizowane
+		przy kadej alokacji, wic zapytanie nie przeglda dysku (czas stay).
+
+		@return Raport o fragmentacji.
+	*/
+	const FragmentationReport GetFragmentationReport();
+
+	/**
+		Sprawdza spjno tablicy FAT, wektora bitowego, wolnego miejsca
+		i drzewa katalogw. acuchy plikw i przedziay blokw s dzielone
+		midzy wszystkie rdzenie procesora. W trybie naprawy acuchy s
+		obcinane w miejscu bdu (blok naley do pierwszego pliku, ktry go
+		uywa), wektor bitowy jest odtwarzany z acuchw, a wolne miejsce
+		i statystyki s przeliczane.
+
+		@param repair Czy naprawi znalezione bdy.
+		@return Raport ze sprawdzania.
+	*/
+	const CheckReport DiskCheck(const bool &repair);
+
+	/**
+		Sprawdza sumy kontrolne CRC32C wszystkich blokw woluminu
+		(wsadowo, instrukcjami procesora, jeli s dostpne).
+
+		@return Raport ze sprawdzania.
+	*/
+	const ScrubReport DiskScrub();
+
+	//---------------------- Plik wymiany -----------------------
+	/**
+		Tworzy w katalogu gwnym plik wymiany o podanym rozmiarze. Plik zajmuje
+		jeden cigy obszar blokw (wszystkie bloki s alokowane od razu), wic
+		odczyt i zapis dowolnego przedziau pliku to jedna sekwencyjna operacja
+		na dysku. Plik wymiany nie moe by usuwany, zmieniany ani przenoszony.
+
+		@param size Rozmiar pliku wymiany w bajtach (zaokrglany w gr do blokw).
+		@return Prawda, jeli plik wymiany zosta utworzony, inaczej fasz.
+	*/
+	const bool SwapCreate(const unsigned int &size);
+
+	/**
+		Odczytuje przedzia pliku wymiany.
+
+		@param offset Pooenie pocztku przedziau w pliku wymiany (bajty).
+		@param length Dugo przedziau (bajty).
+		@return Odczytane dane (pusty cig, jeli przedzia jest niepoprawny).
+	*/
+	const std::string SwapRead(const unsigned int &offset, const unsigned int &length);
+
+	/**
+		Zapisuje dane w pliku wymiany.
+
+		@param offset Pooenie pocztku zapisu w pliku wymiany (bajty).
+		@param data Dane do zapisania.
+		@return Prawda, jeli dane zostay zapisane, inaczej fasz.
+	*/
+	const bool SwapWrite(const unsigned int &offset, const std::string &data);
+
+	//------------------ Dostp wedug cieki ------------------
+	/**
+		Zwraca rzeczywisty rozmiar pliku o podanej penej ciece.
+
+		@param path Pena cieka pliku (np. "/root/katalog/plik").
+		@return Rozmiar pliku w bajtach lub -1, jeli plik nie istnieje.
+	*/
+	const int FileGetSize(const std::string &path);
+
+	/**
+		Odczytuje przedzia pliku o podanej penej ciece. Odczytywane s tylko
+		bloki obejmujce przedzia - acuch FAT jest przechodzony do pierwszego
+		potrzebnego bloku bez odczytu danych wczeniejszych blokw.
+
+		@param path Pena cieka pliku (np. "/root/katalog/plik").
+		@param offset Pooenie pocztku przedziau w pliku (bajty).
+		@param length Dugo przedziau (bajty), przycinana do koca pliku.
+		@return Odczytane dane (pusty cig, jeli plik nie istnieje lub bloki s uszkodzone).
+	*/
+	const std::string FileReadRange(const std::string &path, const unsigned int &offset, const unsigned int &length);
+
+	/**
+		Odczytuje przedzia pliku o podanej penej ciece prosto do podanych buforw
+		(odczyt scatter-gather). Dugo przedziau to czna dugo buforw. acuch FAT
+		przechodzony jest raz, a cige obszary blokw odczytywane s jedn operacj dysku.
+
+		@param path Pena cieka pliku (np. "/root/katalog/plik").
+		@param offset Pooenie pocztku przedziau w pliku (bajty).
+		@param buffers Bufory wypeniane po kolei danymi pliku.
+		@return Liczba odczytanych bajtw (przycinana do koca pliku), 0, jeli bloki s uszkodzone.
+	*/
+	const unsigned int FileReadVectored(const std::string &path, const unsigned int &offset, const std::vector<ReadBuffer> &buffers);
+
 	//------------------ Metody do wywietlania -----------------
 	/**
 		Zmienia zmienn odpowiadajc za wywietlanie komunikatw.
@@ -295,7 +928,7 @@ public:
 		@param level Poziom obecnego katalogu w hierarchii katalogw.
 		@return void.
 	*/
-	void DisplayDirectory(const Directory &directory, unsigned int level);
+	void DisplayDirectory(Directory &directory, unsigned int level);
 
 	/**
 		Wywietla zawarto dysku w formie binarnej.
@@ -332,6 +965,107 @@ public:
 	*/
 	void DisplayFileFragments(const std::vector<std::string> &fileFragments);
 
+	/**
+		Uruchamia t sam syntetyczn seri tworzenia i usuwania plikw na osobnym
+		dysku dla kadej strategii alokacji i wywietla porwnanie: przepustowo,
+		redni koszt przeszukiwania, fragmentacj oraz najwikszy wolny obszar
+		w kolejnych etapach serii.
+
+		@param operations Liczba operacji w serii.
+		@param seed Ziarno generatora liczb losowych (ta sama seria dla kadej strategii).
+		@return void.
+	*/
+	void DisplayAllocationPolicyComparison(const unsigned int &operations, const unsigned int &seed);
+
+	/**
+		Zapisuje i odczytuje sekwencyjnie ten sam plik na osobnym woluminie dla kadej
+		liczby urzdze i wywietla czas operacji, przepustowo i przyspieszenie
+		wzgldem pierwszego woluminu.
+
+		@param deviceCounts Liczby urzdze porwnywanych woluminw.
+		@param fileSize Rozmiar pliku (bajty).
+		@return void.
+	*/
+	void DisplayStripingBenchmark(const std::vector<unsigned int> &deviceCounts, const unsigned int &fileSize);
+
+	/**
+		Wywietla urzdzenia woluminu: rozmiar, wolne miejsce, liczb operacji
+		i czas pracy kadego urzdzenia.
+
+		@return void.
+	*/
+	void DisplayDevices();
+
+	/**
+		Wywietla raport o fragmentacji i wolnym miejscu.
+
+		@return void.
+	*/
+	void DisplayFragmentationReport();
+
+	/**
+		Sprawdza spjno systemu plikw i wywietla raport.
+
+		@param repair Czy naprawi znalezione bdy.
+		@return void.
+	*/
+	void DisplayDiskCheck(const bool &repair);
+
+	/**
+		Sprawdza sumy kontrolne blokw i wywietla raport.
+
+		@return void.
+	*/
+	void DisplayDiskScrub();
+
+	/**
+		Wywietla pliki speniajce kryteria wyszukiwania.
+
+		@param query Kryteria wyszukiwania.
+		@return void.
+	*/
+	void DisplaySearchResults(const SearchQuery &query);
+
+	/**
+		Wywietla statystyki odczytu otwartych plikw (trafienia i skuteczno
+		odczytu z wyprzedzeniem, liczba operacji dysku).
+
+		@return void.
+	*/
+	void DisplayReadAheadStatistics();
+
+	//-------------------- Indeks nazw plikw -------------------
+	/**
+		Wcza lub wycza indeks nazw caego dysku. Wczenie buduje indeks
+		dla wszystkich plikw i katalogw (wczytujc niewczytane katalogi),
+		pniej indeks jest aktualizowany przy tworzeniu, zmianie nazwy
+		i usuwaniu plikw oraz tworzeniu katalogw.
+
+		@param enabled Czy indeks ma by wczony.
+		@return void.
+	*/
+	void NameIndexEnable(const bool &enabled);
+
+	/**
+		Zwraca pene cieki plikw i katalogw, ktrych nazwa zaczyna si
+		od podanego przedrostka. Wymaga wczonego indeksu nazw.
+		Czas zaley od liczby wynikw, a nie od liczby plikw na dysku.
+
+		@param prefix Przedrostek nazwy.
+		@return Posortowane pene cieki.
+	*/
+	const std::vector<std::string> FindByPrefix(const std::string &prefix);
+
+	/**
+		Zwraca pene cieki plikw i katalogw, ktrych nazwa zawiera podany
+		cig znakw. Wymaga wczonego indeksu nazw.
+		Czas zaley od liczby wynikw, a nie od liczby plikw na dysku.
+
+		@param text Szukany cig znakw.
+		@return Posortowane pene cieki.
+	*/
+	const std::vector<std::string> FindBySubstring(const std::string &text);
+
 private:
 	//-------------------- Metody Pomocnicze --------------------
 	/**
@@ -339,42 +1073,51 @@ private:
 
 		@return Rozmiar podanego katalogu.
 	*/
-	const size_t CalculateDirectorySize(const Directory &directory);
+	const size_t CalculateDirectorySize(Directory &directory);
 
 	/**
 		Zwraca rzeczywisty rozmiar podanego katalogu.
 
 		@return Rzeczywisty rozmiar podanego katalogu.
 	*/
-	const size_t CalculateDirectorySizeOnDisk(const Directory &directory);
+	const size_t CalculateDirectorySizeOnDisk(Directory &directory);
 
 	/**
 		Zwraca liczb folderw (katalogw) w danym katalogu i podkatalogach.
 
 		@return Liczba folderw.
 	*/
-	const unsigned int CalculateDirectoryFolderCount(const Directory &directory);
+	const unsigned int CalculateDirectoryFolderCount(Directory &directory);
 
 	/**
 		Zwraca liczb plikw w danym katalogu i podkatalogach.
 
 		@return Liczba plikw.
 	*/
-	const unsigned int CalculateDirectoryFileCount(const Directory &directory);
+	const unsigned int CalculateDirectoryFileCount(Directory &directory);
 
 	/**
-		Zwraca obecnie uywan ciek.
+		Zwraca dugo obecnej cieki.
 
-		@return Obecna cieka z odpowiednim formatowaniem.
+		@return dugo obecnej cieki.
 	*/
-	const std::string GetCurrentPath();
+	const size_t GetCurrentPathLength();
 
 	/**
-		Zwraca dugo obecnej cieki.
+		Zwraca ciek podanego katalogu.
 
-		@return dugo obecnej cieki.
+		@param directory Wskanik na katalog.
+		@return cieka katalogu z odpowiednim formatowaniem.
 	*/
-	const size_t GetCurrentPathLength();
+	const std::string GetDirectoryPath(const Directory* directory);
+
+	/**
+		Zwraca dugo cieki podanego katalogu (bez znakw '/').
+
+		@param directory Wskanik na katalog.
+		@return Dugo cieki katalogu.
+	*/
+	const size_t GetDirectoryPathLength(const Directory* directory);
 
 	/**
 		Zwraca aktualny czas i dat.
@@ -412,13 +1155,172 @@ private:
 	void ChangeBitVectorValue(const unsigned int &block, const bool &value);
 
 	/**
-		Zapisuje wektor fragmentw File.data na dysku.
+		Dodaje wolny obszar do statystyk wolnego miejsca.
+
+		@param begin Indeks pierwszego bloku obszaru.
+		@param length Dugo obszaru (bloki).
+		@return void.
+	*/
+	void AddFreeExtent(const unsigned int &begin, const unsigned int &length);
+
+	/**
+		Usuwa wolny obszar ze statystyk wolnego miejsca.
+
+		@param begin Indeks pierwszego bloku obszaru.
+		@return void.
+	*/
+	void RemoveFreeExtent(const unsigned int &begin);
+
+	/**
+		Zwalnia podane bloki jedn zbiorcz zmian. Bloki s sortowane, a kady cig
+		ssiednich blokw doczany jest do wolnych obszarw jednorazowo, a nie blok po bloku.
+
+		@param blocks Indeksy zajtych blokw do zwolnienia.
+		@return void.
+	*/
+	void FreeBlocks(std::vector<unsigned int> blocks);
+
+	/**
+		Zbiera bloki i cieki plikw poddrzewa katalogu przed jego usuniciem,
+		odejmujc pliki od statystyk, rezerwacji i miejsca obiecanego buforom.
 
-		@param file Plik, ktrego dane bd zapisane na dysku.
-		@param value Dane do zapisania na dysku.
+		@param directory Usuwany katalog (wczytywany, jeli jeszcze nie by).
+		@param path cieka katalogu.
+		@param blocks Wektor, do ktrego dopisywane s bloki danych i zarezerwowane bloki.
+		@param paths Wektor, do ktrego dopisywane s cieki plikw i podkatalogw.
 		@return void.
 	*/
-	void WriteFile(const File &file, const std::string &data);
+	void CollectDirectory(Directory &directory, const std::string &path, std::vector<unsigned int> &blocks, std::vector<std::string> &paths);
+
+	/**
+		Sprawdza, czy w poddrzewie katalogu znajduje si plik wymiany.
+
+		@param directory Sprawdzany katalog (wczytywany, jeli jeszcze nie by).
+		@return Prawda, jeli poddrzewo zawiera plik wymiany, inaczej fasz.
+	*/
+	const bool CheckIfContainsSwap(Directory &directory);
+
+	/**
+		Oprnia bufory plikw katalogu i jego wczytanych podkatalogw.
+
+		@param directory Katalog szczytowy.
+		@return Prawda, jeli zapisano bufory wszystkich plikw, inaczej fasz.
+	*/
+	const bool FlushDirectory(Directory &directory);
+
+	/**
+		Zwraca liczb blokw potrzebnych danym (bloki wypenione zerami staj si dziurami).
+
+		@param data Dane pliku.
+		@return Liczba blokw.
+	*/
+	const unsigned int CountDataBlocks(const std::string &data);
+
+	/**
+		Zwalnia bloki zarezerwowane dla pliku.
+
+		@param file Plik, ktrego rezerwacja ma by zwolniona.
+		@return void.
+	*/
+	void ReleaseReservation(File &file);
+
+	/**
+		Dodaje lub odejmuje udzia pliku w statystykach plikw.
+
+		@param file Plik, ktrego udzia jest zmieniany.
+		@param add Prawda - dodanie pliku, fasz - usunicie.
+		@return void.
+	*/
+	void ChangeFileStatistics(const File &file, const bool &add);
+
+	/**
+		Zapisuje dane z buforw w blokach pliku od podanego przesunicia. Dziury, do ktrych
+		trafiaj niezerowe dane, s alokowane, a nowe bloki logiczne dostaj najpierw bloki
+		zarezerwowane dla pliku.
+
+		@param file Plik przechowywany w blokach.
+		@param offset Przesunicie (bajty) od pocztku pliku.
+		@param buffers Bufory z kolejnymi czciami danych.
+		@return Prawda, jeli dane zostay zapisane, inaczej fasz (za mao miejsca).
+	*/
+	const bool WriteBlocks(File &file, const unsigned int &offset, const std::vector<WriteBuffer> &buffers);
+
+	/**
+		Zwraca pooenie pocztku kadego bufora w poczonych danych.
+
+		@param buffers Bufory.
+		@return Pooenia pocztkw buforw i na kocu czna dugo danych.
+	*/
+	template<typename Buffer>
+	const std::vector<size_t> BufferStarts(const std::vector<Buffer> &buffers);
+
+	/**
+		Wybiera z buforw czci obejmujce przedzia poczonych danych (bez kopiowania danych).
+
+		@param buffers Bufory.
+		@param starts Pooenia pocztkw buforw (z BufferStarts).
+		@param from Pocztek przedziau w poczonych danych.
+		@param length Dugo przedziau.
+		@return Czci buforw w kolejnoci danych.
+	*/
+	template<typename Buffer>
+	const std::vector<Buffer> SliceBuffers(const std::vector<Buffer> &buffers, const std::vector<size_t> &starts, const size_t &from, const size_t &length);
+
+	/**
+		Sprawdza, czy bufory zawieraj same zera.
+
+		@param buffers Bufory.
+		@return Prawda, jeli wszystkie bajty s zerami, inaczej fasz.
+	*/
+	const bool CheckIfBuffersEmpty(const std::vector<WriteBuffer> &buffers);
+
+	/**
+		Kopiuje poczone dane buforw do cigu od podanego przesunicia, powikszajc cig zerami, jeli trzeba.
+
+		@param content Cig, do ktrego kopiowane s dane.
+		@param offset Przesunicie w cigu.
+		@param buffers Bufory.
+		@return void.
+	*/
+	void CopyBuffers(std::string &content, const unsigned int &offset, const std::vector<WriteBuffer> &buffers);
+
+	/**
+		Odczytuje bloki dyskowe w podanej kolejnoci. Cige obszary blokw odczytywane
+		s jedn operacj woluminu, dziury (-1) odczytywane s jako zera.
+
+		@param blocks Indeksy blokw dyskowych.
+		@return Dane blokw (pusty cig, jeli ktry blok jest uszkodzony).
+	*/
+	const std::string ReadBlocks(const std::vector<unsigned int> &blocks);
+
+	/**
+		Zwraca indeksy blokw dyskowych odpowiadajcych kolejnym blokom logicznym pliku.
+		Dziury w pliku oznaczane s wartoci -1.
+
+		@param file Plik, ktrego bloki maj by zwrcone.
+		@return Wektor indeksw blokw (jeden indeks - jeden blok logiczny).
+	*/
+	const std::vector<unsigned int> GetFileBlocks(const File &file);
+
+	/**
+		czy zaalokowane bloki pliku w acuch w tablicy FAT i zapisuje
+		w pliku indeks pierwszego bloku, pooenie dziur i liczb fragmentw.
+		Nie zmienia wektora bitowego.
+
+		@param file Plik, ktrego acuch ma by zbudowany.
+		@param blocks Indeksy blokw kolejnych blokw logicznych (-1 - dziura).
+		@return void.
+	*/
+	void LinkFileBlocks(File &file, const std::vector<unsigned int> &blocks);
+
+	/**
+		Sprawdza czy fragment danych skada si wycznie z zerowych bajtw,
+		czyli czy moe by zapisany jako dziura.
+
+		@param fragment Fragment danych o rozmiarze co najwyej BLOCK_SIZE.
+		@return Prawda, jeli fragment pusty, inaczej fasz.
+	*/
+	const bool CheckIfBlockEmpty(const std::string &fragment);
 
 	/**
 		Dzieli string na fragmenty o rozmiarze BLOCK_SIZE.
@@ -445,16 +1347,8 @@ private:
 	const std::vector<unsigned int> FindUnallocatedBlocksFragmented(unsigned int blockCount);
 
 	/*
-		Znajduje nieuywane bloki do zapisania pliku metod best-fit.
-
-		@param blockCount Liczba blokw na jak szukamy miejsca do alokacji.
-		@return Wektor indeksw blokw do zaalokowania.
-	*/
-	const std::vector<unsigned int> FindUnallocatedBlocksBestFit(const unsigned int &blockCount);
-
-	/*
-		Znajduje nieuywane bloki do zapisania pliku. Najpierw uruchamia funkcj
-		dziaajc metod best-fit, jeli funkcja nie znajdzie dopasowania do
+		Znajduje nieuywane bloki do zapisania pliku. Najpierw uruchamia wybran
+		strategi alokacji, jeli strategia nie znajdzie cigego obszaru to
 		uruchamia funkcj znajdujc pierwsze jakiekolwiek wolne bloki i wprowadza
 		fragmentacj danych.
 
@@ -463,6 +1357,214 @@ private:
 	*/
 	const std::vector<unsigned int> FindUnallocatedBlocks(const unsigned int &blockCount);
 
+	/**
+		Znajduje najmniejszy wolny obszar mieszczcy podan liczb blokw
+		(na podstawie statystyk wolnych obszarw, bez przegldania wektora bitowego).
+
+		@param blockCount Liczba potrzebnych blokw.
+		@return Wektor kolejnych indeksw blokw (pusty, jeli brak takiego obszaru).
+	*/
+	const std::vector<unsigned int> FindContiguousBlocks(const unsigned int &blockCount);
+
+	/**
+		Znajduje plik o podanej penej ciece, wczytujc po drodze niewczytane katalogi.
+
+		@param path Pena cieka pliku (np. "/root/katalog/plik").
+		@return Wskanik na plik lub nullptr, jeli plik nie istnieje.
+	*/
+	File* FindFile(const std::string &path);
+
+	/**
+		Znajduje katalog o podanej penej ciece, wczytujc po drodze niewczytane katalogi.
+
+		@param path Pena cieka katalogu (np. "/root/katalog").
+		@return Wskanik na wczytany katalog lub nullptr, jeli katalog nie istnieje.
+	*/
+	Directory* FindDirectory(const std::string &path);
+
+	/**
+		Odczytuje kolejne bloki logiczne otwartego pliku, przesuwajc kursor acucha FAT.
+		Ssiednie bloki fizyczne odczytywane s jedn operacj dysku, dziury s zerami.
+
+		@param file Plik.
+		@param openFile Wpis pliku w tablicy otwartych plikw.
+		@param first Pierwszy blok logiczny.
+		@param count Liczba blokw.
+		@return Dane kolejnych blokw (kady fragment ma BLOCK_SIZE bajtw), pusty wektor, jeli ktry blok jest uszkodzony.
+	*/
+	const std::vector<std::string> ReadOpenFileBlocks(const File &file, OpenFile &openFile, const unsigned int &first, const unsigned int &count);
+
+	/**
+		Odrzuca bloki odczytane z wyprzedzeniem i kursor otwartego pliku po zmianie
+		jego zawartoci lub acucha.
+
+		@param path Pena cieka pliku.
+		@return void.
+	*/
+	void OpenFileInvalidate(const std::string &path);
+
+	/**
+		Zwraca plik wymiany z katalogu gwnego.
+
+		@return Wskanik na plik wymiany lub nullptr, jeli nie istnieje.
+	*/
+	File* GetSwapFile();
+
+	/**
+		Zwraca dugo najwikszego cigego obszaru wolnych blokw.
+
+		@return Liczba blokw w najwikszym wolnym obszarze.
+	*/
+	const unsigned int CalculateLargestFreeExtent();
+
+	/**
+		Wczytuje zawarto katalogu z obrazu dysku, jeli nie bya jeszcze wczytana.
+		Podkatalogi dodawane s jako niewczytane.
+
+		@param directory Katalog do wczytania.
+		@return void.
+	*/
+	void LoadDirectory(Directory &directory);
+
+	/**
+		Wczytuje z obrazu dysku katalog i cae jego poddrzewo.
+
+		@param directory Katalog szczytowy.
+		@return void.
+	*/
+	void LoadAllDirectories(Directory &directory);
+
+	/**
+		Zbiera wskaniki na wszystkie pliki w katalogu i jego podkatalogach.
+
+		@param directory Katalog szczytowy.
+		@param files Wektor, do ktrego dodawane s pliki.
+		@return void.
+	*/
+	void CollectFiles(Directory &directory, std::vector<File*> &files);
+
+	/**
+		Przelicza od nowa wolne miejsce, wolne obszary i statystyki plikw
+		na podstawie wektora bitowego i drzewa katalogw.
+
+		@return void.
+	*/
+	void RebuildStatistics();
+
+	/**
+		Sprawdza czy nazwa pasuje do wzorca (* - dowolny cig znakw, ? - dowolny znak).
+
+		@param name Sprawdzana nazwa.
+		@param pattern Wzorzec.
+		@return Prawda, jeli nazwa pasuje do wzorca, inaczej fasz.
+	*/
+	const bool MatchPattern(const std::string &name, const std::string &pattern);
+
+	/**
+		Dodaje nazw do indeksu nazw (jeli indeks jest wczony).
+
+		@param name Nazwa pliku lub katalogu.
+		@param path Pena cieka pliku lub katalogu.
+		@return void.
+	*/
+	void NameIndexAdd(const std::string &name, const std::string &path);
+
+	/**
+		Usuwa nazw z indeksu nazw (jeli indeks jest wczony).
+
+		@param name Nazwa pliku lub katalogu.
+		@param path Pena cieka pliku lub katalogu.
+		@return void.
+	*/
+	void NameIndexRemove(const std::string &name, const std::string &path);
+
+	/**
+		Dodaje do indeksu nazw zawarto katalogu i jego podkatalogw.
+
+		@param directory Katalog do zindeksowania.
+		@param path Pena cieka katalogu.
+		@return void.
+	*/
+	void NameIndexDirectory(Directory &directory, const std::string &path);
+
+	/**
+		Zbiera cieki z zakresu indeksu, ktrego klucze zaczynaj si od podanego cigu.
+
+		@param index Przeszukiwany indeks.
+		@param prefix Pocztek klucza.
+		@return Posortowane pene cieki (bez powtrze).
+	*/
+	const std::vector<std::string> NameIndexRange(const std::multimap<std::string, std::string> &index, const std::string &prefix);
+
+	/**
+		Zamienia dat na liczb w postaci RRRRMMDDggmmss, ktr mona porwnywa.
+
+		@param time Data.
+		@return Data w postaci liczby.
+	*/
+	const unsigned long long TimeToNumber(const tm &time);
+
+	/**
+		Dopisuje rekord katalogu (po rekordach jego podkatalogw) do obrazu dysku.
+
+		@param image Bufor z zawartoci obrazu.
+		@param directory Katalog do zapisania.
+		@return Pooenie rekordu katalogu w obrazie.
+	*/
+	const unsigned int AppendDirectoryRecord(std::string &image, Directory &directory);
+
+	/**
+		Dopisuje liczb w zapisie little-endian.
+
+		@param buffer Bufor, do ktrego dopisywana jest liczba.
+		@param value Liczba do zapisania.
+		@param bytes Liczba bajtw zapisu.
+		@return void.
+	*/
+	void AppendNumber(std::string &buffer, const unsigned int &value, const unsigned int &bytes);
+
+	/**
+		Odczytuje liczb zapisan little-endian.
+
+		@param stream Strumie, z ktrego odczytywana jest liczba.
+		@param bytes Liczba bajtw zapisu.
+		@return Odczytana liczba.
+	*/
+	const unsigned int ReadNumber(std::istream &stream, const unsigned int &bytes);
+
+	/**
+		Dopisuje napis poprzedzony jednobajtow dugoci.
+
+		@param buffer Bufor, do ktrego dopisywany jest napis.
+		@param text Napis (maksymalnie 255 znakw).
+		@return void.
+	*/
+	void AppendString(std::string &buffer, const std::string &text);
+
+	/**
+		Odczytuje napis poprzedzony jednobajtow dugoci.
+
+		@param stream Strumie, z ktrego odczytywany jest napis.
+		@return Odczytany napis.
+	*/
+	const std::string ReadString(std::istream &stream);
+
+	/**
+		Dopisuje dat w 7-bajtowym zapisie.
+
+		@param buffer Bufor, do ktrego dopisywana jest data.
+		@param time Data do zapisania.
+		@return void.
+	*/
+	void AppendTime(std::string &buffer, const tm &time);
+
+	/**
+		Odczytuje dat zapisan w 7-bajtowym zapisie.
+
+		@param stream Strumie, z ktrego odczytywana jest data.
+		@return Odczytana data.
+	*/
+	const tm ReadTime(std::istream &stream);
 };
 
 static FileManager fileManager;
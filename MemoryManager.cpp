@@ -3,10 +3,29 @@
 //
 
 #include "MemoryManager.h"
+#include "FileManager.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <climits>
+
+const int MemoryManager::PAGE_SIZE;
+const int MemoryManager::FRAME_COUNT;
 
 PageTable::PageTable(bool bit, int frame) : bit(bit), frame(frame) {}
 
-MemoryManager::MemoryManager() = default;
+MemoryReference::MemoryReference(int pid, int address, bool write) : pid(pid), address(address), write(write) {}
+
+MemoryManager::MemoryManager() {
+    std::fill(RAM, RAM + 256, 0);
+    //Na początku wszystkie ramki są wolne
+    frames.owner.fill(-1);
+    for (int i = FRAME_COUNT - 1; i >= 0; i--) {
+        FreeFrame(i);
+    }
+    replacementPolicy = std::unique_ptr<ReplacementPolicy>(new LRUPolicy());
+    ConfigureTLB(8, 2, TLBReplacementType::LRU, true);
+}
 
 MemoryManager::~MemoryManager() = default;
 
@@ -24,3 +43,883 @@ MemoryManager::Page::Page() {
         this->data[i] = data[i];
     }
 }
+
+//------------------- Algorytmy zastępowania -------------------
+
+void MemoryManager::FIFOPolicy::Loaded(const int &frame) {
+    queue.push_back(frame);
+}
+
+void MemoryManager::FIFOPolicy::Freed(const int &frame) {
+    queue.remove(frame);
+}
+
+const int MemoryManager::FIFOPolicy::SelectVictim(FrameTable &, const std::bitset<FRAME_COUNT> &candidates) {
+    //Najstarsza stronica jest na początku kolejki
+    for (auto frame = queue.begin(); frame != queue.end(); ++frame) {
+        if (candidates[*frame]) {
+            const int victim = *frame;
+            queue.erase(frame);
+            return victim;
+        }
+    }
+    return -1;
+}
+
+void MemoryManager::LRUPolicy::Loaded(const int &frame) {
+    lastUse[frame] = ++time;
+}
+
+void MemoryManager::LRUPolicy::Accessed(const int &frame) {
+    lastUse[frame] = ++time;
+}
+
+const int MemoryManager::LRUPolicy::SelectVictim(FrameTable &, const std::bitset<FRAME_COUNT> &candidates) {
+    int victim = -1;
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        if (candidates[i] && (victim == -1 || lastUse[i] < lastUse[victim])) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+const int MemoryManager::ClockPolicy::SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) {
+    if (candidates.none()) { return -1; }
+    while (true) {
+        const int current = hand;
+        hand = (hand + 1) % FRAME_COUNT;
+        //Stronica z ustawionym bitem odwołania dostaje drugą szansę
+        if (candidates[current]) {
+            if (frames.referenced[current]) { frames.referenced[current] = false; }
+            else { return current; }
+        }
+    }
+}
+
+MemoryManager::OptimalPolicy::OptimalPolicy(const std::vector<std::pair<int, int>> &future) : future(future) {}
+
+void MemoryManager::OptimalPolicy::Referenced(const int &pid, const int &page) {
+    //Przesunięcie za obecne odwołanie
+    while (position < future.size() && future[position] != std::make_pair(pid, page)) { position++; }
+    if (position < future.size()) { position++; }
+}
+
+const int MemoryManager::OptimalPolicy::SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) {
+    int victim = -1;
+    size_t farthest = 0;
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        if (!candidates[i]) { continue; }
+        //Pozycja następnego odwołania do którejkolwiek stronicy w ramce (koniec ciągu, jeśli odwołania nie będzie)
+        const std::vector<std::pair<int, int>> &mappings = frames.mappings[i];
+        size_t next = position;
+        while (next < future.size() && std::find(mappings.begin(), mappings.end(), future[next]) == mappings.end()) { next++; }
+        if (victim == -1 || next > farthest) {
+            victim = i;
+            farthest = next;
+        }
+    }
+    return victim;
+}
+
+//------------------------- Procesy -------------------------
+
+void MemoryManager::CreateProcess(const int &pid, const std::string &program) {
+    if (processes.find(pid) != processes.end()) {
+        std::cout << "Proces o identyfikatorze " << pid << " już istnieje!\n";
+        return;
+    }
+    AddressSpace &space = processes[pid];
+    //Podział programu na stronice
+    for (size_t i = 0; i < program.size() || i == 0; i += PAGE_SIZE) {
+        space.pages.push_back(Page(program.substr(std::min(i, program.size()), PAGE_SIZE)));
+        space.pageTable.push_back(PageTable(false, -1));
+    }
+    space.fileBacked.assign(space.pages.size(), false);
+    space.lastReference.assign(space.pages.size(), 0);
+}
+
+const bool MemoryManager::LoadProgram(const int &pid, FileManager &fileManager, const std::string &path, const int &textSize) {
+    if (processes.find(pid) != processes.end()) {
+        std::cout << "Proces o identyfikatorze " << pid << " już istnieje!\n";
+        return false;
+    }
+    const int size = fileManager.FileGetSize(path);
+    if (size == -1) { return false; }
+
+    //Tylko tablica stronic - żadna część pliku nie jest jeszcze odczytywana
+    AddressSpace &space = processes[pid];
+    const int pageCount = std::max(1, (size + PAGE_SIZE - 1) / PAGE_SIZE);
+    space.pages.resize(pageCount);
+    space.pageTable.assign(pageCount, PageTable(false, -1));
+    space.programDevice = &fileManager;
+    space.programPath = path;
+    space.fileBacked.assign(pageCount, true);
+    space.lastReference.assign(pageCount, 0);
+    //Stronice kodu
+    for (int page = 0; page < pageCount && (page + 1) * PAGE_SIZE <= textSize; page++) {
+        space.pageTable[page].readOnly = true;
+    }
+    return true;
+}
+
+const bool MemoryManager::Fork(const int &parentPid, const int &childPid) {
+    auto parent = processes.find(parentPid);
+    if (parent == processes.end()) {
+        std::cout << "Brak procesu o identyfikatorze " << parentPid << "!\n";
+        return false;
+    }
+    if (processes.find(childPid) != processes.end()) {
+        std::cout << "Proces o identyfikatorze " << childPid << " już istnieje!\n";
+        return false;
+    }
+
+    //Kopia tablicy stronic - dane w pamięci fizycznej nie są kopiowane
+    AddressSpace &child = processes[childPid] = parent->second;
+    child.time = 0;
+    child.lastReference.assign(child.pages.size(), 0);
+    for (size_t page = 0; page < child.pageTable.size(); page++) {
+        PageTable &parentEntry = parent->second.pageTable[page];
+        PageTable &childEntry = child.pageTable[page];
+        if (parentEntry.bit) {
+            frames.mappings[parentEntry.frame].push_back({ childPid, (int)page });
+            //Zapis do współdzielonej ramki wymaga najpierw jej skopiowania
+            if (!parentEntry.readOnly) {
+                parentEntry.copyOnWrite = true;
+                childEntry.copyOnWrite = true;
+            }
+        }
+        //Kopia w pliku wymiany jest współdzielona do czasu zapisania nowej
+        if (childEntry.swapSlot != -1) { swapSlots[childEntry.swapSlot]++; }
+    }
+    return true;
+}
+
+void MemoryManager::RemoveProcess(const int &pid) {
+    auto process = processes.find(pid);
+    if (process == processes.end()) {
+        std::cout << "Brak procesu o identyfikatorze " << pid << "!\n";
+        return;
+    }
+    //Zwolnienie ramek i miejsc w pliku wymiany procesu (ramki współdzielone zostają u pozostałych procesów)
+    for (size_t page = 0; page < process->second.pageTable.size(); page++) {
+        const PageTable &entry = process->second.pageTable[page];
+        if (entry.bit) { UnmapFrame(entry.frame, pid, page); }
+        if (entry.swapSlot != -1) { FreeSwapSlot(entry.swapSlot); }
+    }
+    TLBInvalidate(pid);
+    processes.erase(process);
+}
+
+//------------------------- Dostęp -------------------------
+
+const char MemoryManager::Read(const int &pid, const int &address) {
+    const int physical = Translate(pid, address, false);
+    if (physical == -1) { return 0; }
+    statistics.cost += MEMORY_ACCESS_COST;
+    return RAM[physical];
+}
+
+void MemoryManager::Write(const int &pid, const int &address, const char &value) {
+    const int physical = Translate(pid, address, true);
+    if (physical == -1) { return; }
+    statistics.cost += MEMORY_ACCESS_COST;
+    RAM[physical] = value;
+}
+
+const int MemoryManager::Translate(const int &pid, const int &address, const bool &write) {
+    auto process = processes.find(pid);
+    if (process == processes.end()) {
+        std::cout << "Brak procesu o identyfikatorze " << pid << "!\n";
+        return -1;
+    }
+    const int page = address / PAGE_SIZE;
+    if (address < 0 || page >= (int)process->second.pageTable.size()) {
+        std::cout << "Adres " << address << " poza przestrzenią adresową procesu " << pid << "!\n";
+        return -1;
+    }
+    PageTable &entry = process->second.pageTable[page];
+    if (write && entry.readOnly) {
+        std::cout << "Zapis do stronicy tylko do odczytu (proces " << pid << ", adres " << address << ")!\n";
+        return -1;
+    }
+
+    statistics.accesses++;
+    replacementPolicy->Referenced(pid, page);
+    process->second.lastReference[page] = ++process->second.time;
+
+    //Przełączenie kontekstu - bez identyfikatorów procesów TLB musi zostać opróżniony
+    if (tlb.currentAsid != pid) {
+        if (!tlb.asidTagging && !tlb.entries.empty()) {
+            for (TLBEntry &tlbEntry : tlb.entries) { tlbEntry.valid = false; }
+            statistics.tlbFlushes++;
+        }
+        tlb.currentAsid = pid;
+    }
+
+    //Szybka ścieżka - tłumaczenie z TLB
+    int frame = TLBLookup(pid, page);
+    if (frame != -1) {
+        replacementPolicy->Accessed(frame);
+    }
+    else {
+        //Przejście tablicy stronic
+        statistics.cost += PAGE_WALK_COST;
+        if (!entry.bit && HandlePageFault(pid, page) == -1) { return -1; }
+        else {
+            replacementPolicy->Accessed(entry.frame);
+        }
+        frame = entry.frame;
+        TLBInsert(pid, page, frame);
+    }
+
+    //Zapis do współdzielonej ramki
+    if (write && entry.copyOnWrite) {
+        frame = CopyOnWrite(pid, page);
+        if (frame == -1) {
+            std::cout << "Brak ramki na kopię stronicy " << page << " procesu " << pid << " - wszystkie ramki są przypięte!\n";
+            return -1;
+        }
+    }
+
+    //Pierwsze odwołanie do dociągniętej stronicy - uniknięty błąd braku stronicy
+    if (frames.prefetched[frame]) {
+        frames.prefetched[frame] = false;
+        statistics.prefetchHits++;
+    }
+
+    frames.referenced[frame] = true;
+    if (write) { frames.dirty[frame] = true; }
+    return frame * PAGE_SIZE + address % PAGE_SIZE;
+}
+
+const int MemoryManager::HandlePageFault(const int &pid, const int &page) {
+    statistics.pageFaults++;
+
+    AddressSpace &space = processes[pid];
+    PageTable &entry = space.pageTable[page];
+
+    //Niezmieniona stronica pliku programu może już być w ramce innego procesu
+    if (entry.swapSlot == -1 && space.fileBacked[page]) {
+        auto text = textFrames.find(std::make_tuple(space.programDevice, space.programPath, page));
+        if (text != textFrames.end()) {
+            frames.mappings[text->second].push_back({ pid, page });
+            space.residentPages++;
+            entry.bit = true;
+            entry.frame = text->second;
+            entry.copyOnWrite = !entry.readOnly;
+            statistics.sharedFaults++;
+            replacementPolicy->Accessed(text->second);
+            return text->second;
+        }
+    }
+
+    const int frame = AllocateFrame();
+    if (frame == -1) {
+        std::cout << "Brak ramki dla stronicy " << page << " procesu " << pid << " - wszystkie ramki są przypięte!\n";
+        return -1;
+    }
+    //Nieudany odczyt - ramka wraca do wolnych, żeby jej poprzednia zawartość nie stała się stronicą
+    if (!LoadPage(pid, page, frame, "")) {
+        FreeFrame(frame);
+        return -1;
+    }
+    statistics.cost += PAGE_TRANSFER_COST;
+
+    //Dociągnięcie kolejnych stronic, jeśli błędy następują po sobie
+    Prefetch(pid, page);
+    return frame;
+}
+
+const bool MemoryManager::LoadPage(const int &pid, const int &page, const int &frame, const std::string &fileData) {
+    AddressSpace &space = processes[pid];
+    PageTable &entry = space.pageTable[page];
+
+    //Załadowanie stronicy do ramki - z pliku wymiany, jeśli jest tam jej kopia
+    bool text = false;
+    if (entry.swapSlot != -1) {
+        const std::string data = swapDevice->SwapRead(entry.swapSlot * PAGE_SIZE, PAGE_SIZE);
+        //Brak pliku wymiany (np. po ponownym zamontowaniu dysku) - stronica nie może zostać odtworzona
+        if (data.empty()) {
+            std::cout << "Nie udało się odczytać stronicy " << page << " procesu " << pid << " z pliku wymiany!\n";
+            return false;
+        }
+        std::copy(data.begin(), data.end(), RAM + frame * PAGE_SIZE);
+        statistics.swapIns++;
+    }
+    else if (space.fileBacked[page]) {
+        //Odczyt tylko bloków pliku obejmujących stronicę (o ile nie zostały już odczytane), koniec pliku dopełniany jak w Page(std::string)
+        std::string data = fileData.empty() ? space.programDevice->FileReadRange(space.programPath, page * PAGE_SIZE, PAGE_SIZE) : fileData;
+        data.resize(PAGE_SIZE, ' ');
+        std::copy(data.begin(), data.end(), RAM + frame * PAGE_SIZE);
+        statistics.programReads++;
+        //Ramka staje się dostępna dla innych procesów wykonujących ten sam plik
+        textFrames[std::make_tuple(space.programDevice, space.programPath, page)] = frame;
+        text = true;
+    }
+    else {
+        std::copy(space.pages[page].data, space.pages[page].data + PAGE_SIZE, RAM + frame * PAGE_SIZE);
+    }
+
+    entry.copyOnWrite = text && !entry.readOnly;
+    MapFrame(frame, pid, page, false, text);
+    return true;
+}
+
+void MemoryManager::Prefetch(const int &pid, const int &page) {
+    AddressSpace &space = processes[pid];
+    //Błąd poza ciągiem - dociąganie wyłączone do czasu potwierdzenia nowego ciągu
+    if (prefetchLimit == 0 || page != space.nextSequentialFault) {
+        space.nextSequentialFault = page + 1;
+        space.prefetchWindow = 0;
+        return;
+    }
+    //Pierwszy błąd sekwencyjny tylko potwierdza ciąg
+    if (space.prefetchWindow == 0) {
+        space.nextSequentialFault = page + 1;
+        space.prefetchWindow = 1;
+        return;
+    }
+    const int last = std::min(page + space.prefetchWindow, (int)space.pageTable.size() - 1);
+    space.nextSequentialFault = last + 1;
+    space.prefetchWindow = std::min(space.prefetchWindow * 2, prefetchLimit);
+
+    //Stronice, które nie mogą być dociągnięte (już w pamięci lub w ramce innego procesu)
+    const auto skip = [&](const int &i) {
+        return space.pageTable[i].bit || (space.pageTable[i].swapSlot == -1 && space.fileBacked[i]
+            && textFrames.count(std::make_tuple(space.programDevice, space.programPath, i)) > 0);
+    };
+    //Stronice czytane z pliku programu
+    const auto fromFile = [&](const int &i) { return space.pageTable[i].swapSlot == -1 && space.fileBacked[i]; };
+
+    //Ramki stronicy, która spowodowała błąd i dociągniętych stronic są przypięte do końca dociągania
+    std::vector<int> pinned(1, space.pageTable[page].frame);
+    frames.pinCount[pinned.back()]++;
+    for (int first = page + 1; first <= last; ) {
+        if (skip(first)) { first++; continue; }
+
+        //Ciąg sąsiednich stronic pliku odczytywany jest jednym przejściem łańcucha FAT
+        int end = first + 1;
+        std::string run;
+        if (fromFile(first)) {
+            while (end <= last && !skip(end) && fromFile(end)) { end++; }
+            run = space.programDevice->FileReadRange(space.programPath, first * PAGE_SIZE, (end - first) * PAGE_SIZE);
+            run.resize((end - first) * PAGE_SIZE, ' ');
+        }
+        statistics.cost += PAGE_TRANSFER_COST;
+
+        for (int i = first; i < end; i++) {
+            const int frame = AllocateFrame();
+            if (frame == -1) { end = last + 1; break; }
+            if (!LoadPage(pid, i, frame, run.empty() ? "" : run.substr((i - first) * PAGE_SIZE, PAGE_SIZE))) {
+                FreeFrame(frame);
+                continue;
+            }
+            frames.prefetched[frame] = true;
+            frames.pinCount[frame]++;
+            pinned.push_back(frame);
+            statistics.prefetchIssued++;
+        }
+        first = end;
+    }
+    for (const int &frame : pinned) { frames.pinCount[frame]--; }
+}
+
+const int MemoryManager::AllocateFrame() {
+    //Brak wolnych ramek - ramka zwalniana przez algorytm zastępowania
+    if (frames.freeCount == 0) {
+        //Kandydaci to nieprzypięte ramki, a jeśli jest ich dość, tylko te spoza zbiorów roboczych
+        std::bitset<FRAME_COUNT> candidates, outsideWorkingSets;
+        for (int i = 0; i < FRAME_COUNT; i++) {
+            if (frames.owner[i] == -1 || frames.pinCount[i] > 0) { continue; }
+            candidates[i] = true;
+            if (workingSetWindow == 0) { continue; }
+            bool used = false;
+            for (const std::pair<int, int> &mapping : frames.mappings[i]) { used = used || InWorkingSet(mapping.first, mapping.second); }
+            outsideWorkingSets[i] = !used;
+        }
+        if (outsideWorkingSets.any()) { candidates = outsideWorkingSets; }
+
+        const int victim = replacementPolicy->SelectVictim(frames, candidates);
+        if (victim == -1) { return -1; }
+        EvictFrame(victim);
+    }
+
+    //Pobranie ramki z początku listy wolnych ramek
+    const int frame = frames.freeHead;
+    frames.freeHead = frames.nextFree[frame];
+    frames.freeCount--;
+    return frame;
+}
+
+void MemoryManager::MapFrame(const int &frame, const int &pid, const int &page, const bool &dirty, const bool &text) {
+    PageTable &entry = processes[pid].pageTable[page];
+    entry.bit = true;
+    entry.frame = frame;
+    processes[pid].residentPages++;
+
+    frames.owner[frame] = pid;
+    frames.mappings[frame].assign(1, { pid, page });
+    frames.dirty[frame] = dirty;
+    frames.referenced[frame] = false;
+    frames.text[frame] = text;
+    frames.prefetched[frame] = false;
+    frames.pinCount[frame] = 0;
+    replacementPolicy->Loaded(frame);
+}
+
+void MemoryManager::FreeFrame(const int &frame) {
+    frames.owner[frame] = -1;
+    frames.mappings[frame].clear();
+    frames.dirty[frame] = false;
+    frames.referenced[frame] = false;
+    frames.text[frame] = false;
+    frames.prefetched[frame] = false;
+    frames.pinCount[frame] = 0;
+
+    //Dołączenie ramki na początek listy wolnych ramek
+    frames.nextFree[frame] = frames.freeHead;
+    frames.freeHead = frame;
+    frames.freeCount++;
+}
+
+void MemoryManager::EvictFrame(const int &frame) {
+    ForgetTextFrame(frame);
+
+    //Dociągnięta stronica usuwana bez użycia - okno dociągania właściciela jest zmniejszane
+    if (frames.prefetched[frame]) {
+        statistics.prefetchWasted++;
+        AddressSpace &owner = processes[frames.owner[frame]];
+        owner.prefetchWindow /= 2;
+    }
+
+    for (const std::pair<int, int> &mapping : frames.mappings[frame]) {
+        AddressSpace &space = processes[mapping.first];
+        PageTable &entry = space.pageTable[mapping.second];
+
+        //Zmieniona stronica musi zostać zapisana - do pliku wymiany, a gdy go brakuje lub jest pełny, do obrazu procesu
+        if (frames.dirty[frame]) {
+            //Miejsce współdzielone z innym procesem zawiera starszą wersję stronicy
+            if (entry.swapSlot != -1 && swapSlots[entry.swapSlot] > 1) {
+                FreeSwapSlot(entry.swapSlot);
+                entry.swapSlot = -1;
+            }
+            if (swapDevice != nullptr && entry.swapSlot == -1) { entry.swapSlot = AllocateSwapSlot(); }
+            if (entry.swapSlot != -1) {
+                swapDevice->SwapWrite(entry.swapSlot * PAGE_SIZE, std::string(RAM + frame * PAGE_SIZE, PAGE_SIZE));
+                statistics.swapOuts++;
+            }
+            else {
+                std::copy(RAM + frame * PAGE_SIZE, RAM + (frame + 1) * PAGE_SIZE, space.pages[mapping.second].data);
+                space.fileBacked[mapping.second] = false;
+            }
+            statistics.cost += PAGE_TRANSFER_COST;
+            statistics.writeBacks++;
+        }
+        entry.bit = false;
+        entry.frame = -1;
+        entry.copyOnWrite = false;
+        space.residentPages--;
+        TLBInvalidate(mapping.first, mapping.second);
+    }
+    statistics.evictions++;
+
+    replacementPolicy->Freed(frame);
+    FreeFrame(frame);
+}
+
+void MemoryManager::UnmapFrame(const int &frame, const int &pid, const int &page) {
+    processes[pid].residentPages--;
+    //Ostatni użytkownik ramki - ramka jest zwalniana bez zapisywania
+    if (frames.mappings[frame].size() == 1) {
+        ForgetTextFrame(frame);
+        replacementPolicy->Freed(frame);
+        FreeFrame(frame);
+        return;
+    }
+    std::vector<std::pair<int, int>> &mappings = frames.mappings[frame];
+    mappings.erase(std::find(mappings.begin(), mappings.end(), std::make_pair(pid, page)));
+    frames.owner[frame] = mappings.front().first;
+    //Jedyny pozostały użytkownik zmienionej ramki może zapisywać ją bez kopiowania
+    if (mappings.size() == 1 && !frames.text[frame]) {
+        processes[mappings.front().first].pageTable[mappings.front().second].copyOnWrite = false;
+    }
+}
+
+const int MemoryManager::CopyOnWrite(const int &pid, const int &page) {
+    PageTable &entry = processes[pid].pageTable[page];
+    const int shared = entry.frame;
+
+    //Jedyny użytkownik ramki zapisuje w niej bezpośrednio, ramka przestaje być stronicą pliku programu
+    if (frames.mappings[shared].size() == 1) {
+        ForgetTextFrame(shared);
+        entry.copyOnWrite = false;
+        return shared;
+    }
+
+    //Współdzielona ramka jest przypięta, żeby nie została wybrana do usunięcia w trakcie kopiowania
+    frames.pinCount[shared]++;
+    const int frame = AllocateFrame();
+    frames.pinCount[shared]--;
+    if (frame == -1) { return -1; }
+
+    std::copy(RAM + shared * PAGE_SIZE, RAM + (shared + 1) * PAGE_SIZE, RAM + frame * PAGE_SIZE);
+    statistics.copyOnWriteCopies++;
+    statistics.cost += PAGE_SIZE * MEMORY_ACCESS_COST;
+    const bool dirty = frames.dirty[shared];
+    UnmapFrame(shared, pid, page);
+    TLBInvalidate(pid, page);
+
+    entry.copyOnWrite = false;
+    MapFrame(frame, pid, page, dirty, false);
+    TLBInsert(pid, page, frame);
+    return frame;
+}
+
+void MemoryManager::ForgetTextFrame(const int &frame) {
+    if (!frames.text[frame]) { return; }
+    const std::pair<int, int> &mapping = frames.mappings[frame].front();
+    const AddressSpace &space = processes[mapping.first];
+    textFrames.erase(std::make_tuple(space.programDevice, space.programPath, mapping.second));
+    frames.text[frame] = false;
+}
+
+//------------------- Przypinanie i zbiór roboczy -------------------
+
+const bool MemoryManager::PinPage(const int &pid, const int &address) {
+    //Odwołanie ładuje stronicę, jeśli jej brak
+    if (Translate(pid, address, false) == -1) { return false; }
+    const int page = address / PAGE_SIZE;
+    const PageTable &entry = processes[pid].pageTable[page];
+    //Współdzielona ramka kopiowana jest przed przypięciem - inaczej pierwszy zapis przeniósłby stronicę
+    //do nowej, nieprzypiętej ramki, a przypięcie zostałoby na ramce innego procesu
+    if (entry.copyOnWrite && frames.mappings[entry.frame].size() > 1 && CopyOnWrite(pid, page) == -1) {
+        std::cout << "Brak ramki na kopię stronicy " << page << " procesu " << pid << " - wszystkie ramki są przypięte!\n";
+        return false;
+    }
+    if (frames.pinCount[entry.frame] == UCHAR_MAX) {
+        std::cout << "Przekroczono limit przypięć ramki " << entry.frame << "!\n";
+        return false;
+    }
+    frames.pinCount[entry.frame]++;
+    return true;
+}
+
+void MemoryManager::UnpinPage(const int &pid, const int &address) {
+    auto process = processes.find(pid);
+    if (process == processes.end() || address < 0 || address / PAGE_SIZE >= (int)process->second.pageTable.size()) {
+        std::cout << "Niepoprawny adres " << address << " procesu " << pid << "!\n";
+        return;
+    }
+    const PageTable &entry = process->second.pageTable[address / PAGE_SIZE];
+    if (!entry.bit || frames.pinCount[entry.frame] == 0) {
+        std::cout << "Stronica pod adresem " << address << " procesu " << pid << " nie jest przypięta!\n";
+        return;
+    }
+    frames.pinCount[entry.frame]--;
+}
+
+void MemoryManager::SetPrefetchLimit(const int &limit) {
+    prefetchLimit = std::max(0, limit);
+}
+
+void MemoryManager::SetWorkingSetWindow(const unsigned long long &window) {
+    workingSetWindow = window;
+}
+
+const bool MemoryManager::InWorkingSet(const int &pid, const int &page) const {
+    const AddressSpace &space = processes.at(pid);
+    return space.lastReference[page] != 0 && space.time - space.lastReference[page] < workingSetWindow;
+}
+
+const int MemoryManager::GetWorkingSetSize(const int &pid) const {
+    auto process = processes.find(pid);
+    if (process == processes.end() || workingSetWindow == 0) { return 0; }
+    int size = 0;
+    for (size_t page = 0; page < process->second.lastReference.size(); page++) {
+        size += InWorkingSet(pid, page);
+    }
+    return size;
+}
+
+const int MemoryManager::GetResidentSetSize(const int &pid) const {
+    auto process = processes.find(pid);
+    return process == processes.end() ? 0 : process->second.residentPages;
+}
+
+//----------------------- Plik wymiany -----------------------
+
+const bool MemoryManager::AttachSwap(FileManager &fileManager, const int &slots) {
+    if (swapDevice != nullptr) {
+        std::cout << "Plik wymiany jest już podłączony!\n";
+        return false;
+    }
+    if (slots <= 0 || !fileManager.SwapCreate(slots * PAGE_SIZE)) { return false; }
+
+    swapDevice = &fileManager;
+    swapSlots.assign(slots, 0);
+    swapCursor = 0;
+    return true;
+}
+
+const int MemoryManager::AllocateSwapSlot() {
+    //Szukanie od miejsca za ostatnio przydzielonym, dzięki czemu kolejne zapisy trafiają obok siebie
+    for (size_t i = 0; i < swapSlots.size(); i++) {
+        const int slot = (swapCursor + i) % swapSlots.size();
+        if (swapSlots[slot] == 0) {
+            swapSlots[slot] = 1;
+            swapCursor = (slot + 1) % swapSlots.size();
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void MemoryManager::FreeSwapSlot(const int &slot) {
+    swapSlots[slot]--;
+}
+
+//--------------------------- TLB ---------------------------
+
+const int MemoryManager::TLBLookup(const int &pid, const int &page) {
+    if (tlb.entries.empty()) { return -1; }
+
+    const int set = page % (int(tlb.entries.size()) / tlb.ways);
+    tlb.time++;
+    for (int i = set * tlb.ways; i < (set + 1) * tlb.ways; i++) {
+        TLBEntry &entry = tlb.entries[i];
+        //Bez identyfikatorów procesów w TLB są tylko wpisy bieżącego procesu
+        if (entry.valid && entry.page == page && (!tlb.asidTagging || entry.asid == pid)) {
+            entry.lastUse = tlb.time;
+            statistics.tlbHits++;
+            return entry.frame;
+        }
+    }
+    statistics.tlbMisses++;
+    return -1;
+}
+
+void MemoryManager::TLBInsert(const int &pid, const int &page, const int &frame) {
+    if (tlb.entries.empty()) { return; }
+
+    const int set = page % (int(tlb.entries.size()) / tlb.ways);
+    int victim = -1;
+    //Najpierw wolny wpis w zbiorze
+    for (int i = set * tlb.ways; i < (set + 1) * tlb.ways && victim == -1; i++) {
+        if (!tlb.entries[i].valid) { victim = i; }
+    }
+    if (victim == -1) {
+        if (tlb.replacement == TLBReplacementType::Random) {
+            victim = set * tlb.ways + int(tlb.random() % tlb.ways);
+        }
+        else {
+            victim = set * tlb.ways;
+            for (int i = set * tlb.ways + 1; i < (set + 1) * tlb.ways; i++) {
+                if (tlb.entries[i].lastUse < tlb.entries[victim].lastUse) { victim = i; }
+            }
+        }
+    }
+
+    TLBEntry &entry = tlb.entries[victim];
+    entry.valid = true;
+    entry.asid = pid;
+    entry.page = page;
+    entry.frame = frame;
+    entry.lastUse = tlb.time;
+}
+
+void MemoryManager::TLBInvalidate(const int &pid, const int &page) {
+    for (TLBEntry &entry : tlb.entries) {
+        if (entry.valid && entry.asid == pid && (page == -1 || entry.page == page)) {
+            entry.valid = false;
+        }
+    }
+}
+
+void MemoryManager::ConfigureTLB(const int &entries, const int &ways, const TLBReplacementType &replacement, const bool &asidTagging) {
+    if (entries < 0 || (entries > 0 && (ways <= 0 || entries % ways != 0))) {
+        std::cout << "Liczba wpisów TLB musi być wielokrotnością liczby wpisów w zbiorze!\n";
+        return;
+    }
+    tlb.entries.assign(entries, TLBEntry());
+    tlb.ways = entries > 0 ? ways : 1;
+    tlb.replacement = replacement;
+    tlb.asidTagging = asidTagging;
+    tlb.currentAsid = -1;
+    tlb.time = 0;
+}
+
+//---------------------- Algorytm i statystyki ----------------------
+
+void MemoryManager::SetReplacementPolicy(const ReplacementPolicyType &type, const std::vector<MemoryReference> &future) {
+    switch (type) {
+    case ReplacementPolicyType::FIFO: replacementPolicy = std::unique_ptr<ReplacementPolicy>(new FIFOPolicy()); break;
+    case ReplacementPolicyType::LRU: replacementPolicy = std::unique_ptr<ReplacementPolicy>(new LRUPolicy()); break;
+    case ReplacementPolicyType::Clock: replacementPolicy = std::unique_ptr<ReplacementPolicy>(new ClockPolicy()); break;
+    case ReplacementPolicyType::Optimal: {
+        std::vector<std::pair<int, int>> pages;
+        for (const MemoryReference &reference : future) { pages.push_back({ reference.pid, reference.address / PAGE_SIZE }); }
+        replacementPolicy = std::unique_ptr<ReplacementPolicy>(new OptimalPolicy(pages));
+        break;
+    }
+    }
+    //Nowy algorytm musi znać ramki już zajęte
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        if (frames.owner[i] != -1) { replacementPolicy->Loaded(i); }
+    }
+}
+
+const MemoryManager::Statistics MemoryManager::GetStatistics() const {
+    return statistics;
+}
+
+void MemoryManager::DisplayStatistics() const {
+    std::cout << "Policy: " << replacementPolicy->Name() << '\n';
+    std::cout << "Accesses: " << statistics.accesses << '\n';
+    std::cout << "Page faults: " << statistics.pageFaults << " ("
+              << (statistics.accesses == 0 ? 0.0 : 100.0 * statistics.pageFaults / statistics.accesses) << "%)\n";
+    std::cout << "Evictions: " << statistics.evictions << ", write-backs: " << statistics.writeBacks << '\n';
+    std::cout << "Average access cost: " << (statistics.accesses == 0 ? 0.0 : (double)statistics.cost / statistics.accesses) << '\n';
+    std::cout << "TLB hits: " << statistics.tlbHits << ", misses: " << statistics.tlbMisses << " ("
+              << (statistics.tlbHits + statistics.tlbMisses == 0 ? 0.0 : 100.0 * statistics.tlbHits / (statistics.tlbHits + statistics.tlbMisses))
+              << "% hit rate), flushes: " << statistics.tlbFlushes << '\n';
+    std::cout << "Program page reads: " << statistics.programReads << '\n';
+    std::cout << "Prefetched pages: " << statistics.prefetchIssued << ", used: " << statistics.prefetchHits << " ("
+              << (statistics.prefetchIssued == 0 ? 0.0 : 100.0 * statistics.prefetchHits / statistics.prefetchIssued)
+              << "% accuracy, faults avoided), evicted unused: " << statistics.prefetchWasted << '\n';
+    //Liczba ramek w użyciu i liczba stronic na nie odwzorowanych (różnica to oszczędność ze współdzielenia)
+    size_t usedFrames = 0, mappedPages = 0;
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        usedFrames += frames.owner[frame] != -1;
+        mappedPages += frames.mappings[frame].size();
+    }
+    std::cout << "Frames in use: " << usedFrames << ", mapped pages: " << mappedPages << ", shared faults: " << statistics.sharedFaults
+              << ", copy-on-write copies: " << statistics.copyOnWriteCopies << '\n';
+    if (swapDevice != nullptr) {
+        std::cout << "Swap: " << swapSlots.size() - std::count(swapSlots.begin(), swapSlots.end(), 0) << '/' << swapSlots.size()
+                  << " slots used, swap-ins: " << statistics.swapIns << ", swap-outs: " << statistics.swapOuts << '\n';
+    }
+}
+
+void MemoryManager::DisplayPageTable(const int &pid) const {
+    auto process = processes.find(pid);
+    if (process == processes.end()) {
+        std::cout << "Brak procesu o identyfikatorze " << pid << "!\n";
+        return;
+    }
+    for (size_t i = 0; i < process->second.pageTable.size(); i++) {
+        const PageTable &entry = process->second.pageTable[i];
+        std::cout << std::setw(3) << i << ". " << entry.bit << ' ' << (entry.bit ? std::to_string(entry.frame) : "-") << '\n';
+    }
+}
+
+void MemoryManager::DisplayRAM() const {
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        std::cout << std::setw(2) << frame << ". ";
+        for (int i = 0; i < PAGE_SIZE; i++) {
+            const char c = RAM[frame * PAGE_SIZE + i];
+            std::cout << (c >= 32 && c < 127 ? c : '.');
+        }
+        for (const std::pair<int, int> &mapping : frames.mappings[frame]) {
+            std::cout << " pid " << mapping.first << " page " << mapping.second;
+        }
+        if (frames.pinCount[frame] > 0) { std::cout << " (pinned)"; }
+        std::cout << '\n';
+    }
+}
+
+void MemoryManager::DisplayTLB() const {
+    if (tlb.entries.empty()) {
+        std::cout << "TLB disabled\n";
+        return;
+    }
+    std::cout << "TLB: " << tlb.entries.size() << " entries, " << tlb.ways << "-way, "
+              << (tlb.replacement == TLBReplacementType::LRU ? "LRU" : "random")
+              << (tlb.asidTagging ? ", ASID tagged" : "") << '\n';
+    for (size_t i = 0; i < tlb.entries.size(); i++) {
+        const TLBEntry &entry = tlb.entries[i];
+        if (i % tlb.ways == 0) { std::cout << "Set " << i / tlb.ways << ":\n"; }
+        std::cout << "  ";
+        if (entry.valid) { std::cout << "pid " << entry.asid << " page " << entry.page << " -> frame " << entry.frame << '\n'; }
+        else { std::cout << "-\n"; }
+    }
+}
+
+void MemoryManager::DisplayWorkingSets() const {
+    int workingSetTotal = 0;
+    std::cout << std::left << std::setw(6) << "PID" << std::setw(8) << "Pages" << std::setw(6) << "RSS" << "Working set\n";
+    for (const auto &process : processes) {
+        const int workingSet = GetWorkingSetSize(process.first);
+        workingSetTotal += workingSet;
+        std::cout << std::setw(6) << process.first << std::setw(8) << process.second.pageTable.size()
+                  << std::setw(6) << process.second.residentPages << workingSet << '\n';
+    }
+    std::cout << std::right;
+    std::cout << "Free frames: " << frames.freeCount << '/' << FRAME_COUNT << '\n';
+    //Suma zbiorów roboczych większa od pamięci oznacza szamotanie
+    if (workingSetTotal > FRAME_COUNT) {
+        std::cout << "Working sets need " << workingSetTotal << " frames, only " << FRAME_COUNT << " available - thrashing likely\n";
+    }
+}
+
+void MemoryManager::DisplayReplacementPolicyComparison(const std::map<int, std::string> &programs, const std::vector<MemoryReference> &references) {
+    //Formatowanie std::cout jest przywracane na końcu, żeby nie wpływało na późniejsze wypisywanie
+    const std::ios::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    const ReplacementPolicyType types[] = { ReplacementPolicyType::FIFO, ReplacementPolicyType::LRU,
+                                            ReplacementPolicyType::Clock, ReplacementPolicyType::Optimal };
+
+    std::cout << std::left << std::setw(8) << "Policy" << std::setw(10) << "Faults" << std::setw(12) << "Fault rate"
+              << "Avg access cost\n";
+    for (const ReplacementPolicyType &type : types) {
+        //Każdy algorytm dostaje osobną, pustą pamięć
+        MemoryManager memory;
+        memory.SetReplacementPolicy(type, references);
+        for (const auto &program : programs) { memory.CreateProcess(program.first, program.second); }
+        for (const MemoryReference &reference : references) {
+            if (reference.write) { memory.Write(reference.pid, reference.address, 'w'); }
+            else { memory.Read(reference.pid, reference.address); }
+        }
+
+        const Statistics result = memory.GetStatistics();
+        std::cout << std::setw(8) << memory.replacementPolicy->Name() << std::setw(10) << result.pageFaults
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << (result.accesses == 0 ? 0.0 : 100.0 * result.pageFaults / result.accesses)
+                  << (result.accesses == 0 ? 0.0 : (double)result.cost / result.accesses) << '\n';
+    }
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+void MemoryManager::DisplayTLBComparison(const std::map<int, std::string> &programs, const std::vector<MemoryReference> &references,
+                                         const std::vector<int> &sizes, const int &ways, const bool &asidTagging) {
+    const std::ios::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(8) << "Entries" << std::setw(10) << "Hits" << std::setw(10) << "Misses"
+              << std::setw(10) << "Hit rate" << "Avg access cost\n";
+    for (const int &size : sizes) {
+        //Rozmiar odrzucany przez ConfigureTLB jest pomijany - wiersz pokazałby wyniki domyślnego TLB
+        const int setWays = size > 0 ? std::min(ways, size) : 1;
+        if (size < 0 || (size > 0 && (setWays <= 0 || size % setWays != 0))) {
+            std::cout << std::setw(8) << size << "pominięto - liczba wpisów nie jest wielokrotnością " << ways << "\n";
+            continue;
+        }
+        //Każdy rozmiar dostaje osobną, pustą pamięć z tym samym algorytmem zastępowania stronic
+        MemoryManager memory;
+        memory.SetReplacementPolicy(ReplacementPolicyType::LRU);
+        memory.ConfigureTLB(size, setWays, TLBReplacementType::LRU, asidTagging);
+        for (const auto &program : programs) { memory.CreateProcess(program.first, program.second); }
+        for (const MemoryReference &reference : references) {
+            if (reference.write) { memory.Write(reference.pid, reference.address, 'w'); }
+            else { memory.Read(reference.pid, reference.address); }
+        }
+
+        const Statistics result = memory.GetStatistics();
+        const unsigned long long lookups = result.tlbHits + result.tlbMisses;
+        std::cout << std::setw(8) << size << std::setw(10) << result.tlbHits << std::setw(10) << result.tlbMisses
+                  << std::setw(10) << std::fixed << std::setprecision(2) << (lookups == 0 ? 0.0 : 100.0 * result.tlbHits / lookups)
+                  << (result.accesses == 0 ? 0.0 : (double)result.cost / result.accesses) << '\n';
+    }
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
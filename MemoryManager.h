@@ -7,17 +7,72 @@
 
 #include <list>
 #include <string>
+#include <array>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <bitset>
+#include <tuple>
 //#include "Processes.h"
 
+class FileManager;
+
 /* Tablica stronic */
 struct PageTable {
     bool bit;  //Wartość bool'owska sprawdzająca zajętość tablicy w pamięci
     int frame; //Numer ramki w której znajduje się stronica
+    int swapSlot = -1; //Numer miejsca w pliku wymiany z kopią stronicy (-1 - brak kopii)
+    bool readOnly = false;    //Czy stronica jest tylko do odczytu (kod programu)
+    bool copyOnWrite = false; //Czy ramka stronicy jest współdzielona i zapis wymaga skopiowania jej
 
     PageTable(bool bit, int frame);
 };
 
+/* Odwołanie do pamięci (element ciągu odwołań) */
+struct MemoryReference {
+    int pid;     //Identyfikator procesu
+    int address; //Adres logiczny
+    bool write;  //Czy odwołanie jest zapisem
+
+    MemoryReference(int pid, int address, bool write = false);
+};
+
 class MemoryManager {
+public:
+    //Dostępne algorytmy zastępowania stronic
+    enum class ReplacementPolicyType { FIFO, LRU, Clock, Optimal };
+    //Dostępne algorytmy zastępowania wpisów TLB
+    enum class TLBReplacementType { LRU, Random };
+
+    //Statystyki odwołań do pamięci
+    struct Statistics {
+        unsigned long long accesses = 0;   //Liczba odwołań do pamięci
+        unsigned long long pageFaults = 0; //Liczba błędów braku stronicy
+        unsigned long long evictions = 0;  //Liczba usuniętych z pamięci stronic
+        unsigned long long writeBacks = 0; //Liczba zmienionych stronic zapisanych przy usuwaniu
+        unsigned long long cost = 0;       //Łączny koszt odwołań (w jednostkach dostępu do pamięci)
+        unsigned long long tlbHits = 0;    //Liczba trafień w TLB
+        unsigned long long tlbMisses = 0;  //Liczba chybień w TLB
+        unsigned long long tlbFlushes = 0; //Liczba opróżnień TLB przy przełączaniu kontekstu
+        unsigned long long swapIns = 0;    //Liczba stronic wczytanych z pliku wymiany
+        unsigned long long swapOuts = 0;   //Liczba stronic zapisanych w pliku wymiany
+        unsigned long long programReads = 0; //Liczba stronic wczytanych z plików programów
+        unsigned long long sharedFaults = 0; //Liczba błędów braku stronicy obsłużonych przez dołączenie współdzielonej ramki
+        unsigned long long copyOnWriteCopies = 0; //Liczba ramek skopiowanych przy zapisie do współdzielonej stronicy
+        unsigned long long prefetchIssued = 0; //Liczba stronic dociągniętych przed odwołaniem
+        unsigned long long prefetchHits = 0;   //Liczba dociągniętych stronic użytych przed usunięciem (uniknięte błędy braku stronicy)
+        unsigned long long prefetchWasted = 0; //Liczba dociągniętych stronic usuniętych bez użycia
+    };
+
+    static const int PAGE_SIZE = 16;                //Rozmiar stronicy i ramki (bajty)
+    static const int FRAME_COUNT = 256 / PAGE_SIZE; //Liczba ramek w pamięci fizycznej
+
+    //Koszty używane w statystykach (w jednostkach dostępu do pamięci)
+    static const int MEMORY_ACCESS_COST = 1;  //Odczyt lub zapis bajtu w pamięci fizycznej
+    static const int PAGE_WALK_COST = 1;      //Odczyt wpisu tablicy stronic
+    static const int PAGE_TRANSFER_COST = 100; //Przeniesienie stronicy między pamięcią a pamięcią pomocniczą
+
 private:
     char RAM[256]; //Pamięć Fizyczna Komputera [256 bajtów]
 
@@ -29,10 +84,231 @@ private:
         Page(std::string data);
     };
 
+    //Przestrzeń adresowa procesu
+    struct AddressSpace {
+        std::vector<PageTable> pageTable; //Tablica stronic procesu
+        std::vector<Page> pages;          //Stronice procesu przechowywane poza pamięcią fizyczną
+
+        //Program wczytywany z pliku przy pierwszym odwołaniu do stronicy
+        FileManager* programDevice = nullptr; //Zarządca plików z plikiem programu (nullptr - program podany przy tworzeniu)
+        std::string programPath;               //Pełna ścieżka pliku programu
+        std::vector<bool> fileBacked;          //Czy zawartość stronicy nadal znajduje się tylko w pliku programu
+
+        //Zbiór roboczy
+        unsigned long long time = 0;                 //Czas wirtualny procesu (liczba jego odwołań do pamięci)
+        std::vector<unsigned long long> lastReference; //Czas wirtualny ostatniego odwołania do stronicy (0 - brak odwołań)
+        int residentPages = 0;                       //Liczba stronic procesu w pamięci fizycznej (RSS)
+
+        //Dociąganie stronic
+        int nextSequentialFault = -1; //Stronica, której błąd oznacza kontynuację sekwencyjnego przebiegu
+        int prefetchWindow = 0;       //Liczba stronic dociąganych przy następnym błędzie sekwencyjnym (0 - ciąg niepotwierdzony)
+    };
+
+    //Informacje o ramkach pamięci fizycznej, przechowywane jako osobne tablice (jeden indeks - jedna ramka)
+    struct FrameTable {
+        std::array<int, FRAME_COUNT> owner;                                    //Proces, któremu ramka jest przypisana (-1 - ramka wolna)
+        std::array<std::vector<std::pair<int, int>>, FRAME_COUNT> mappings;   //Stronice (proces, stronica) odwzorowane na ramkę
+        std::bitset<FRAME_COUNT> dirty;                                       //Czy stronica została zmieniona od załadowania
+        std::bitset<FRAME_COUNT> referenced;                                  //Bit odwołania (używany przez algorytm zegarowy)
+        std::bitset<FRAME_COUNT> text;                                        //Czy ramka zawiera niezmienioną stronicę pliku programu dostępną dla innych procesów
+        std::bitset<FRAME_COUNT> prefetched;                                  //Czy stronica została dociągnięta i nie było jeszcze do niej odwołania
+        std::array<unsigned char, FRAME_COUNT> pinCount{};                    //Liczba przypięć ramki (przypiętej ramki nie można zwolnić)
+
+        //Lista wolnych ramek zapisana w samych ramkach
+        std::array<int, FRAME_COUNT> nextFree; //Następna wolna ramka na liście (-1 - koniec listy)
+        int freeHead = -1;                     //Pierwsza wolna ramka (-1 - brak wolnych ramek)
+        int freeCount = 0;                     //Liczba wolnych ramek
+    };
+
+    //Wpis TLB
+    struct TLBEntry {
+        bool valid = false;              //Czy wpis jest ważny
+        int asid = -1;                   //Identyfikator przestrzeni adresowej (procesu)
+        int page = -1;                   //Numer stronicy
+        int frame = -1;                  //Numer ramki
+        unsigned long long lastUse = 0;  //Czas ostatniego użycia (dla LRU)
+    };
+
+    //Programowy bufor TLB (zbiorowo-skojarzeniowy)
+    struct TLB {
+        std::vector<TLBEntry> entries;                              //Wpisy, zbiór i zajmuje pozycje [i*ways, (i+1)*ways)
+        int ways = 1;                                               //Liczba wpisów w zbiorze
+        TLBReplacementType replacement = TLBReplacementType::LRU;   //Algorytm zastępowania wpisów
+        bool asidTagging = true;                                    //Czy wpisy są oznaczane identyfikatorem procesu
+        int currentAsid = -1;                                       //Proces, którego odwołania były ostatnie
+        unsigned long long time = 0;                                //Licznik odwołań do TLB
+        std::mt19937 random{ 0 };                                   //Generator dla losowego zastępowania
+    };
+
+    //Interfejs algorytmu zastępowania stronic
+    class ReplacementPolicy {
+    public:
+        virtual ~ReplacementPolicy() = default;
+
+        //Nazwa algorytmu
+        virtual const std::string Name() const = 0;
+        //Wywoływana przy każdym odwołaniu do pamięci, przed tłumaczeniem adresu
+        virtual void Referenced(const int &, const int &) {}
+        //Wywoływana po załadowaniu stronicy do ramki
+        virtual void Loaded(const int &) {}
+        //Wywoływana przy odwołaniu do stronicy znajdującej się w ramce
+        virtual void Accessed(const int &) {}
+        //Wywoływana po zwolnieniu ramki
+        virtual void Freed(const int &) {}
+        //Wybiera ramkę spośród kandydatów, z której zostanie usunięta stronica
+        virtual const int SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) = 0;
+    };
+
+    //Usuwana jest stronica najdłużej przebywająca w pamięci
+    class FIFOPolicy : public ReplacementPolicy {
+        std::list<int> queue; //Ramki w kolejności załadowania
+    public:
+        const std::string Name() const override { return "FIFO"; }
+        void Loaded(const int &frame) override;
+        void Freed(const int &frame) override;
+        const int SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) override;
+    };
+
+    //Usuwana jest stronica najdawniej używana
+    class LRUPolicy : public ReplacementPolicy {
+        unsigned long long time = 0;                          //Licznik odwołań
+        std::array<unsigned long long, FRAME_COUNT> lastUse{}; //Czas ostatniego odwołania do ramki
+    public:
+        const std::string Name() const override { return "LRU"; }
+        void Loaded(const int &frame) override;
+        void Accessed(const int &frame) override;
+        const int SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) override;
+    };
+
+    //Algorytm zegarowy (druga szansa)
+    class ClockPolicy : public ReplacementPolicy {
+        int hand = 0; //Wskazówka zegara
+    public:
+        const std::string Name() const override { return "CLOCK"; }
+        const int SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) override;
+    };
+
+    //Algorytm optymalny - usuwana jest stronica, do której odwołanie nastąpi najpóźniej
+    class OptimalPolicy : public ReplacementPolicy {
+        std::vector<std::pair<int, int>> future; //Ciąg przyszłych odwołań (proces, stronica)
+        size_t position = 0;                     //Pozycja w ciągu odwołań
+    public:
+        OptimalPolicy(const std::vector<std::pair<int, int>> &future);
+        const std::string Name() const override { return "OPT"; }
+        void Referenced(const int &pid, const int &page) override;
+        const int SelectVictim(FrameTable &frames, const std::bitset<FRAME_COUNT> &candidates) override;
+    };
+
+    std::map<int, AddressSpace> processes;               //Przestrzenie adresowe procesów
+    FrameTable frames;                                   //Ramki pamięci fizycznej
+    unsigned long long workingSetWindow = 0;             //Okno zbioru roboczego (odwołania procesu, 0 - bez ochrony zbioru roboczego)
+    int prefetchLimit = 4;                               //Największe okno dociągania stronic (0 - dociąganie wyłączone)
+    std::unique_ptr<ReplacementPolicy> replacementPolicy; //Algorytm zastępowania stronic
+    Statistics statistics;                               //Statystyki odwołań
+    TLB tlb;                                             //Bufor TLB
+
+    //Plik wymiany na dysku zarządcy plików
+    FileManager* swapDevice = nullptr; //Zarządca plików przechowujący plik wymiany (nullptr - brak pliku wymiany)
+    std::vector<int> swapSlots;        //Liczba stronic używających miejsca w pliku wymiany (jedno miejsce - jedna stronica)
+    int swapCursor = 0;                //Miejsce, od którego szukane jest następne wolne miejsce
+
+    //Ramki ze stronicami plików programów (zarządca plików, ścieżka, stronica) -> ramka
+    std::map<std::tuple<FileManager*, std::string, int>, int> textFrames;
+
 public:
 
     MemoryManager();
     virtual ~MemoryManager();
+
+    //Tworzy przestrzeń adresową procesu, program dzielony jest na stronice (żadna nie jest ładowana do pamięci)
+    void CreateProcess(const int &pid, const std::string &program);
+    //Tworzy przestrzeń adresową procesu dla programu z pliku, stronice wczytywane są z pliku dopiero przy błędzie braku stronicy
+    //Stronice leżące w całości w pierwszych textSize bajtach są tylko do odczytu
+    const bool LoadProgram(const int &pid, FileManager &fileManager, const std::string &path, const int &textSize = 0);
+    //Tworzy proces potomny współdzielący ramki rodzica, ramki są kopiowane dopiero przy zapisie
+    const bool Fork(const int &parentPid, const int &childPid);
+    //Usuwa przestrzeń adresową procesu i zwalnia jego ramki
+    void RemoveProcess(const int &pid);
+
+    //Odczytuje bajt spod adresu logicznego procesu
+    const char Read(const int &pid, const int &address);
+    //Zapisuje bajt pod adresem logicznym procesu
+    void Write(const int &pid, const int &address, const char &value);
+
+    //Zmienia algorytm zastępowania stronic (algorytm optymalny wymaga ciągu przyszłych odwołań)
+    void SetReplacementPolicy(const ReplacementPolicyType &type, const std::vector<MemoryReference> &future = {});
+
+    //Tworzy plik wymiany na podanym dysku, zmienione stronice usuwane z pamięci będą w nim zapisywane
+    const bool AttachSwap(FileManager &fileManager, const int &slots);
+
+    //Przypina stronicę w pamięci (ładując ją, jeśli jej brak) - przypiętej stronicy nie można usunąć z pamięci
+    const bool PinPage(const int &pid, const int &address);
+    //Odpina stronicę przypiętą przez PinPage
+    void UnpinPage(const int &pid, const int &address);
+
+    //Ustawia największą liczbę stronic dociąganych przy sekwencyjnym błędzie braku stronicy (0 - wyłącza dociąganie)
+    void SetPrefetchLimit(const int &limit);
+
+    //Ustawia okno zbioru roboczego - stronice używane w ostatnich window odwołaniach procesu są usuwane tylko, gdy nie ma innych
+    void SetWorkingSetWindow(const unsigned long long &window);
+    //Zwraca rozmiar zbioru roboczego procesu (liczba stronic używanych w ostatnich window odwołaniach procesu)
+    const int GetWorkingSetSize(const int &pid) const;
+    //Zwraca liczbę stronic procesu w pamięci fizycznej
+    const int GetResidentSetSize(const int &pid) const;
+
+    //Zmienia konfigurację TLB (opróżniając go), 0 wpisów wyłącza TLB
+    void ConfigureTLB(const int &entries, const int &ways, const TLBReplacementType &replacement, const bool &asidTagging);
+
+    const Statistics GetStatistics() const;
+    void DisplayStatistics() const;
+    void DisplayPageTable(const int &pid) const;
+    void DisplayRAM() const;
+    void DisplayTLB() const;
+    void DisplayWorkingSets() const;
+
+    //Wykonuje ten sam ciąg odwołań dla każdego algorytmu zastępowania i wyświetla częstość błędów i koszt
+    void DisplayReplacementPolicyComparison(const std::map<int, std::string> &programs, const std::vector<MemoryReference> &references);
+    //Wykonuje ten sam ciąg odwołań dla każdego rozmiaru TLB i wyświetla częstość trafień i koszt
+    void DisplayTLBComparison(const std::map<int, std::string> &programs, const std::vector<MemoryReference> &references,
+                              const std::vector<int> &sizes, const int &ways, const bool &asidTagging);
+
+private:
+    //Tłumaczy adres logiczny na fizyczny, obsługując błąd braku stronicy (-1 - adres niepoprawny)
+    const int Translate(const int &pid, const int &address, const bool &write);
+    //Ładuje stronicę procesu do wolnej ramki (lub ramki zwolnionej przez algorytm zastępowania), -1 przy błędzie
+    const int HandlePageFault(const int &pid, const int &page);
+    //Wczytuje stronicę procesu do ramki (fileData - odczytana już zawartość stronicy pliku programu), fałsz przy błędzie odczytu
+    const bool LoadPage(const int &pid, const int &page, const int &frame, const std::string &fileData);
+    //Po sekwencyjnym błędzie braku stronicy dociąga kolejne stronice procesu, zwiększając okno dociągania
+    void Prefetch(const int &pid, const int &page);
+    //Zwraca wolną ramkę, usuwając stronicę wybraną przez algorytm zastępowania, jeśli wolnych ramek brak (-1 - wszystkie ramki przypięte)
+    const int AllocateFrame();
+    //Przypisuje ramkę stronicy procesu jako jej jedyne odwzorowanie
+    void MapFrame(const int &frame, const int &pid, const int &page, const bool &dirty, const bool &text);
+    //Zwraca ramkę na listę wolnych ramek
+    void FreeFrame(const int &frame);
+    //Czy stronica procesu należy do jego zbioru roboczego
+    const bool InWorkingSet(const int &pid, const int &page) const;
+    //Usuwa stronicę z ramki (u wszystkich procesów, które ją współdzielą), zapisując ją jeśli była zmieniona
+    void EvictFrame(const int &frame);
+    //Usuwa odwzorowanie stronicy procesu na ramkę, zwalniając ramkę, jeśli nikt jej już nie używa
+    void UnmapFrame(const int &frame, const int &pid, const int &page);
+    //Daje procesowi prywatną kopię współdzielonej ramki przed zapisem (zwraca ramkę stronicy)
+    const int CopyOnWrite(const int &pid, const int &page);
+    //Usuwa ramkę z ramek stronic plików programów
+    void ForgetTextFrame(const int &frame);
+
+    //Przydziela miejsce w pliku wymiany, kolejne miejsca przydzielane są po sobie (-1 - brak miejsca)
+    const int AllocateSwapSlot();
+    //Zwalnia miejsce w pliku wymiany
+    void FreeSwapSlot(const int &slot);
+
+    //Szuka tłumaczenia stronicy w TLB (-1 - chybienie)
+    const int TLBLookup(const int &pid, const int &page);
+    //Wstawia tłumaczenie stronicy do TLB, zastępując wpis w zbiorze jeśli jest pełny
+    void TLBInsert(const int &pid, const int &page, const int &frame);
+    //Unieważnia wpis TLB dla stronicy procesu (page == -1 - wszystkie wpisy procesu)
+    void TLBInvalidate(const int &pid, const int &page = -1);
 };
 
 
@@ -0,0 +1,107 @@
+/**
+	SexyOS
+	ThreadPool.cpp
+	Przeznaczenie: Zawiera definicje metod i konstruktorów dla klasy z ThreadPool.h
+
+	@version 19/10/26
+*/
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local unsigned int ThreadPool::currentWorker = 0;
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+	if (threadCount == 0) { threadCount = std::max(1u, std::thread::hardware_concurrency()); }
+
+	for (unsigned int i = 0; i < threadCount; i++) {
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+	for (unsigned int i = 0; i < threadCount; i++) {
+		threads.emplace_back(&ThreadPool::Run, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+	for (std::thread &thread : threads) { thread.join(); }
+}
+
+void ThreadPool::Submit(const std::function<void()> &task) {
+	pending++;
+
+	//Zadanie zlecone przez wątek puli trafia do jego kolejki, inne zadania są rozdzielane po kolei
+	const unsigned int index = currentPool == this ? currentWorker : nextWorker++ % workers.size();
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks.push_back(task);
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queued++;
+	}
+	wakeUp.notify_one();
+}
+
+void ThreadPool::Wait() {
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	finished.wait(lock, [this] { return pending == 0; });
+}
+
+const unsigned int ThreadPool::Size() const {
+	return threads.size();
+}
+
+const bool ThreadPool::PopTask(const unsigned int &index, std::function<void()> &task) {
+	//Najpierw najświeższe zadanie z własnej kolejki
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		if (!workers[index]->tasks.empty()) {
+			task = std::move(workers[index]->tasks.back());
+			workers[index]->tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+	//Potem najstarsze zadanie podkradzione z kolejki innego wątku
+	for (unsigned int i = 1; i < workers.size(); i++) {
+		Worker &victim = *workers[(index + i) % workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::Run(const unsigned int index) {
+	currentPool = this;
+	currentWorker = index;
+
+	while (true) {
+		std::function<void()> task;
+		if (PopTask(index, task)) {
+			task();
+			//Ostatnie zakończone zadanie budzi czekających na pulę
+			if (--pending == 0) {
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				finished.notify_all();
+			}
+			continue;
+		}
+
+		//Brak zadań - wątek zasypia do czasu zlecenia nowego zadania
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeUp.wait(lock, [this] { return stopping || queued > 0; });
+		if (stopping && queued == 0) { return; }
+	}
+}
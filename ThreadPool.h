@@ -0,0 +1,107 @@
+/**
+	SexyOS
+	ThreadPool.h
+	Przeznaczenie: Zawiera klasę ThreadPool - pulę wątków z podkradaniem zadań (work stealing)
+
+	@version 19/10/26
+*/
+
+#ifndef SEXYOS_THREADPOOL_H
+#define SEXYOS_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+	Pula wątków z podkradaniem zadań. Każdy wątek ma własną kolejkę zadań.
+	Zadania zlecane z wnętrza zadania trafiają do kolejki bieżącego wątku
+	i są z niej pobierane od końca (najświeższe najpierw), a bezczynne wątki
+	podkradają zadania z początku kolejek innych wątków.
+*/
+class ThreadPool {
+private:
+	//Kolejka zadań jednego wątku
+	struct Worker {
+		std::deque<std::function<void()>> tasks; //Zadania czekające na wykonanie
+		std::mutex mutex;                        //Blokada kolejki
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers; //Kolejki wątków
+	std::vector<std::thread> threads;             //Wątki robocze
+
+	std::atomic<unsigned int> pending{ 0 };    //Liczba zadań zleconych i jeszcze niezakończonych
+	std::atomic<unsigned int> queued{ 0 };     //Liczba zadań czekających w kolejkach
+	std::atomic<unsigned int> nextWorker{ 0 }; //Kolejka, do której trafi następne zadanie zlecone z zewnątrz
+	bool stopping = false;                     //Czy pula jest zamykana
+
+	std::mutex sleepMutex;              //Blokada usypiania wątków
+	std::condition_variable wakeUp;     //Budzenie wątków po zleceniu zadania
+	std::condition_variable finished;   //Powiadomienie o zakończeniu wszystkich zadań
+
+	static thread_local ThreadPool* currentPool;    //Pula, do której należy obecny wątek
+	static thread_local unsigned int currentWorker; //Numer obecnego wątku w puli
+
+public:
+	//----------------------- Konstruktor -----------------------
+	/**
+		Konstruktor uruchamiający podaną liczbę wątków.
+
+		@param threadCount Liczba wątków (0 - liczba rdzeni procesora).
+	*/
+	explicit ThreadPool(unsigned int threadCount = 0);
+
+	/**
+		Destruktor. Czeka na zakończenie zleconych zadań i zatrzymuje wątki.
+	*/
+	~ThreadPool();
+
+	//-------------------------- Metody -------------------------
+	/**
+		Zleca zadanie do wykonania. Zadanie może zlecać kolejne zadania.
+
+		@param task Zadanie do wykonania.
+		@return void.
+	*/
+	void Submit(const std::function<void()> &task);
+
+	/**
+		Czeka, aż wszystkie zlecone zadania (również zlecone przez inne zadania)
+		zostaną wykonane. Nie może być wywoływana z wnętrza zadania.
+
+		@return void.
+	*/
+	void Wait();
+
+	/**
+		Zwraca liczbę wątków w puli.
+
+		@return Liczba wątków.
+	*/
+	const unsigned int Size() const;
+
+private:
+	/**
+		Pobiera zadanie z własnej kolejki lub podkrada je z kolejki innego wątku.
+
+		@param index Numer wątku pobierającego zadanie.
+		@param task Zmienna, do której zapisywane jest pobrane zadanie.
+		@return Prawda, jeśli pobrano zadanie, inaczej fałsz.
+	*/
+	const bool PopTask(const unsigned int &index, std::function<void()> &task);
+
+	/**
+		Pętla wątku roboczego.
+
+		@param index Numer wątku.
+		@return void.
+	*/
+	void Run(const unsigned int index);
+};
+
+#endif //SEXYOS_THREADPOOL_H
@@ -1,6 +1,459 @@
+#include "FileManager.h"
+#include "MemoryManager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 
-int main() {
-    std::cout << "Hello, World!" << std::endl;
-    return 0;
-}
\ No newline at end of file
+//Nieinteraktywny sterownik wykonujący skrypty poleceń dla zarządcy plików i zarządcy pamięci
+//
+//Użycie: main [-q] [-s ziarno] [skrypt]  (bez skryptu polecenia czytane są ze standardowego wejścia)
+//  -q  wycisza komunikaty zarządców podczas wykonywania poleceń
+//  -s  ziarno generatora liczb losowych (domyślnie 0, ten sam skrypt daje ten sam przebieg)
+//
+//Polecenia (jedno w wierszu, # rozpoczyna komentarz):
+//  mkdir NAZWA | cd NAZWA|..|/
+//  create NAZWA DANE | append NAZWA DANE | write NAZWA POZYCJA DANE | read NAZWA [ROZMIAR]
+//  open NAZWA | seek NAZWA POZYCJA | close NAZWA  (read z rozmiarem czyta otwarty plik od bieżącej pozycji z wyprzedzeniem)
+//  writev NAZWA POZYCJA DANE... | readv NAZWA ROZMIAR_BUFORA  (wiele buforów w jednej operacji)
+//  delete NAZWA | truncate NAZWA ROZMIAR | rename NAZWA NOWA_NAZWA | move NAZWA ŚCIEŻKA_KATALOGU | rmdir NAZWA
+//  reserve NAZWA ROZMIAR | unreserve NAZWA | delalloc 0|1 | flush NAZWA | sync | scrub
+//  fsck  (sprawdza spójność dysku - wykryty błąd kończy program kodem 1, więc skrypt może służyć jako test)
+//  mspawn PID DANE | mload PID ŚCIEŻKA [ROZMIAR_KODU] | mfork PID PID_POTOMKA | mkill PID
+//  mread PID ADRES | mwrite PID ADRES DANE | swap MIEJSCA
+//  repeat N [ZMIENNA] ... end | set ZMIENNA LICZBA | echo TEKST | stats
+//
+//$ZMIENNA jest zastępowana wartością zmiennej (np. licznika pętli), liczby mogą być sumami iloczynów (np. $i*16+3)
+//oraz rand(N) - losowa liczba z przedziału [0, N). Dane to słowo, tekst w cudzysłowie lub wygenerowany ciąg:
+//gen(N) - N znaków powtarzającego się alfabetu, rand(N) - N losowych liter, zero(N) - N zer (dziura w pliku).
+
+//Polecenie skryptu
+struct Command {
+    int line;                       //Numer wiersza w skrypcie
+    std::vector<std::string> words; //Nazwa polecenia i argumenty
+    size_t end = 0;                 //Indeks polecenia end zamykającego pętlę repeat
+};
+
+class Driver {
+public:
+    Driver(const unsigned int &seed, const bool &quiet);
+
+    //Wczytuje i sprawdza skrypt, zwraca false przy błędzie składni
+    const bool Load(std::istream &script);
+    //Wykonuje wczytany skrypt, zwraca false, jeśli polecenie fsck wykryło błędy
+    const bool Run();
+    //Wyświetla przepustowość i percentyle opóźnień poleceń
+    void DisplayReport() const;
+
+private:
+    FileManager fileManager;
+    MemoryManager memoryManager;
+    std::vector<Command> commands;
+    std::map<std::string, long long> variables; //Zmienne skryptu (liczniki pętli i zmienne z set)
+    std::mt19937 random;
+    bool quiet;
+
+    std::map<std::string, std::vector<double>> latencies; //Opóźnienia wykonanych poleceń (µs) według nazwy polecenia
+    double elapsed = 0;                                   //Łączny czas wykonania poleceń (s)
+    unsigned long long bytesRead = 0;
+    unsigned long long bytesWritten = 0;
+    unsigned int failedChecks = 0; //Liczba poleceń fsck, które wykryły błędy
+
+    void RunBlock(const size_t &begin, const size_t &end);
+    void Execute(const Command &command);
+    //Mierzy czas wykonania operacji i zapisuje go pod nazwą polecenia
+    template<typename Operation>
+    void Measure(const std::string &name, const Operation &operation);
+
+    const std::string Expand(const std::string &word) const;
+    const long long Number(const std::string &word);
+    const std::string Payload(const std::string &word);
+    //Zwraca N z zapisu nazwa(N) lub -1, jeśli słowo ma inną postać
+    static const long long Generator(const std::string &word, const std::string &name);
+};
+
+Driver::Driver(const unsigned int &seed, const bool &quiet) : random(seed), quiet(quiet) {}
+
+const bool Driver::Load(std::istream &script) {
+    //Nazwa polecenia -> najmniejsza i największa liczba argumentów
+    static const std::map<std::string, std::pair<size_t, size_t>> syntax = {
+        {"mkdir", {1, 1}}, {"cd", {1, 1}}, {"create", {2, 2}}, {"append", {2, 2}}, {"write", {3, 3}}, {"read", {1, 2}},
+        {"writev", {3, SIZE_MAX}}, {"readv", {2, 2}}, {"open", {1, 1}}, {"seek", {2, 2}}, {"close", {1, 1}},
+        {"delete", {1, 1}}, {"truncate", {2, 2}}, {"rename", {2, 2}}, {"move", {2, 2}}, {"rmdir", {1, 1}},
+        {"reserve", {2, 2}}, {"unreserve", {1, 1}},
+        {"delalloc", {1, 1}}, {"flush", {1, 1}}, {"sync", {0, 0}}, {"scrub", {0, 0}}, {"fsck", {0, 0}},
+        {"mspawn", {2, 2}}, {"mload", {2, 3}}, {"mfork", {2, 2}}, {"mkill", {1, 1}}, {"mread", {2, 2}}, {"mwrite", {3, 3}},
+        {"swap", {1, 1}}, {"repeat", {1, 2}}, {"end", {0, 0}}, {"set", {2, 2}}, {"echo", {0, SIZE_MAX}}, {"stats", {0, 0}}
+    };
+    //Indeksy otwartych pętli repeat
+    std::vector<size_t> loops;
+    std::string text;
+
+    for (int line = 1; std::getline(script, text); line++) {
+        Command command;
+        command.line = line;
+
+        //Podział wiersza na słowa, tekst w cudzysłowie jest jednym słowem
+        std::istringstream stream(text);
+        std::string word;
+        while (stream >> std::ws && stream.peek() != EOF) {
+            if (stream.peek() == '#') { break; }
+            if (stream.peek() == '"') {
+                stream.get();
+                std::getline(stream, word, '"');
+            }
+            else { stream >> word; }
+            command.words.push_back(word);
+        }
+        if (command.words.empty()) { continue; }
+
+        auto rule = syntax.find(command.words[0]);
+        if (rule == syntax.end()) {
+            std::cout << "Wiersz " << line << ": nieznane polecenie '" << command.words[0] << "'!\n";
+            return false;
+        }
+        const size_t argumentCount = command.words.size() - 1;
+        if (argumentCount < rule->second.first || argumentCount > rule->second.second) {
+            std::cout << "Wiersz " << line << ": niepoprawna liczba argumentów polecenia '" << command.words[0] << "'!\n";
+            return false;
+        }
+
+        if (command.words[0] == "repeat") { loops.push_back(commands.size()); }
+        else if (command.words[0] == "end") {
+            if (loops.empty()) {
+                std::cout << "Wiersz " << line << ": end bez repeat!\n";
+                return false;
+            }
+            commands[loops.back()].end = commands.size();
+            loops.pop_back();
+        }
+        commands.push_back(command);
+    }
+    if (!loops.empty()) {
+        std::cout << "Wiersz " << commands[loops.back()].line << ": repeat bez end!\n";
+        return false;
+    }
+    return true;
+}
+
+const bool Driver::Run() {
+    RunBlock(0, commands.size());
+    return failedChecks == 0;
+}
+
+void Driver::RunBlock(const size_t &begin, const size_t &end) {
+    for (size_t i = begin; i < end; i++) {
+        const Command &command = commands[i];
+        if (command.words[0] == "repeat") {
+            const long long count = Number(command.words[1]);
+            const std::string variable = command.words.size() > 2 ? command.words[2] : "";
+            for (long long iteration = 0; iteration < count; iteration++) {
+                if (!variable.empty()) { variables[variable] = iteration; }
+                RunBlock(i + 1, command.end);
+            }
+            i = command.end;
+        }
+        else { Execute(command); }
+    }
+}
+
+void Driver::Execute(const Command &command) {
+    const std::string &name = command.words[0];
+    //Argumenty po podstawieniu zmiennych
+    std::vector<std::string> args;
+    for (size_t i = 1; i < command.words.size(); i++) { args.push_back(Expand(command.words[i])); }
+
+    if (name == "set") { variables[args[0]] = Number(args[1]); }
+    else if (name == "echo") {
+        for (size_t i = 0; i < args.size(); i++) { std::cout << (i > 0 ? " " : "") << args[i]; }
+        std::cout << '\n';
+    }
+    else if (name == "stats") {
+        memoryManager.DisplayStatistics();
+        fileManager.DisplayFragmentationReport();
+        fileManager.DisplayReadAheadStatistics();
+    }
+    else if (name == "mkdir") { Measure(name, [&] { fileManager.DirectoryCreate(args[0]); }); }
+    else if (name == "cd") {
+        Measure(name, [&] {
+            if (args[0] == "..") { fileManager.DirectoryUp(); }
+            else if (args[0] == "/") { fileManager.DirectoryRoot(); }
+            else { fileManager.DirectoryDown(args[0]); }
+        });
+    }
+    else if (name == "create") {
+        const std::string data = Payload(args[1]);
+        Measure(name, [&] { fileManager.FileCreate(args[0], data); });
+        bytesWritten += data.size();
+    }
+    else if (name == "append" || name == "write") {
+        const std::string data = Payload(args.back());
+        const std::string path = fileManager.GetCurrentPath() + '/' + args[0];
+        const int position = name == "write" ? (int)Number(args[1]) : 0;
+        Measure(name, [&] {
+            //Dopisanie zaczyna się na końcu pliku
+            const int offset = name == "append" ? fileManager.FileGetSize(path) : position;
+            fileManager.FileWrite(args[0], std::max(offset, 0), data);
+        });
+        bytesWritten += data.size();
+    }
+    else if (name == "read" && args.size() == 2) {
+        //Odczyt sekwencyjny otwartego pliku (z odczytem z wyprzedzeniem)
+        const long long length = Number(args[1]);
+        std::string data;
+        Measure(name, [&] { data = fileManager.FileRead(args[0], (unsigned int)std::max(length, 0LL)); });
+        bytesRead += data.size();
+    }
+    else if (name == "read") {
+        const std::string path = fileManager.GetCurrentPath() + '/' + args[0];
+        std::string data;
+        Measure(name, [&] {
+            const int size = fileManager.FileGetSize(path);
+            if (size < 0) { std::cout << "Plik '" << path << "' nie istnieje!\n"; }
+            else { data = fileManager.FileReadRange(path, 0, size); }
+        });
+        bytesRead += data.size();
+    }
+    else if (name == "writev") {
+        std::vector<std::string> data;
+        for (size_t i = 2; i < args.size(); i++) { data.push_back(Payload(args[i])); }
+        std::vector<FileManager::WriteBuffer> buffers;
+        for (const std::string &part : data) {
+            buffers.push_back(FileManager::WriteBuffer{ part.data(), part.size() });
+            bytesWritten += part.size();
+        }
+        const long long position = Number(args[1]);
+        Measure(name, [&] { fileManager.FileWriteVectored(args[0], (unsigned int)std::max(position, 0LL), buffers); });
+    }
+    else if (name == "readv") {
+        const std::string path = fileManager.GetCurrentPath() + '/' + args[0];
+        const size_t bufferSize = (size_t)std::max(Number(args[1]), 1LL);
+        unsigned int read = 0;
+        Measure(name, [&] {
+            const int size = fileManager.FileGetSize(path);
+            if (size < 0) { std::cout << "Plik '" << path << "' nie istnieje!\n"; return; }
+            //Plik dzielony jest na bufory o zadanym rozmiarze
+            std::vector<std::string> data((size + bufferSize - 1) / bufferSize, std::string(bufferSize, '\0'));
+            std::vector<FileManager::ReadBuffer> buffers;
+            for (std::string &part : data) { buffers.push_back(FileManager::ReadBuffer{ &part[0], part.size() }); }
+            read = fileManager.FileReadVectored(path, 0, buffers);
+        });
+        bytesRead += read;
+    }
+    else if (name == "open") { Measure(name, [&] { fileManager.FileOpen(args[0]); }); }
+    else if (name == "seek") {
+        const long long position = Number(args[1]);
+        Measure(name, [&] { fileManager.FileSeek(args[0], (unsigned int)std::max(position, 0LL)); });
+    }
+    else if (name == "close") { Measure(name, [&] { fileManager.FileClose(args[0]); }); }
+    else if (name == "delete") { Measure(name, [&] { fileManager.FileDelete(args[0]); }); }
+    else if (name == "truncate") {
+        const long long size = Number(args[1]);
+        Measure(name, [&] { fileManager.FileTruncate(args[0], (unsigned int)size); });
+    }
+    else if (name == "rename") { Measure(name, [&] { fileManager.FileRename(args[0], args[1]); }); }
+    else if (name == "move") { Measure(name, [&] { fileManager.FileMove(args[0], args[1]); }); }
+    else if (name == "rmdir") { Measure(name, [&] { fileManager.DirectoryDelete(args[0]); }); }
+    else if (name == "reserve") {
+        const long long size = Number(args[1]);
+        Measure(name, [&] { fileManager.FileReserve(args[0], (unsigned int)size); });
+    }
+    else if (name == "unreserve") { Measure(name, [&] { fileManager.FileReleaseReservation(args[0]); }); }
+    else if (name == "delalloc") {
+        const bool enabled = Number(args[0]) != 0;
+        Measure(name, [&] { fileManager.SetDelayedAllocation(enabled); });
+    }
+    else if (name == "flush") { Measure(name, [&] { fileManager.FileFlush(args[0]); }); }
+    else if (name == "sync") { Measure(name, [&] { fileManager.DiskSync(); }); }
+    else if (name == "fsck") {
+        FileManager::CheckReport report;
+        Measure(name, [&] { report = fileManager.DiskCheck(false); });
+        if (report.brokenChains + report.crossLinkedBlocks + report.leakedBlocks + report.unmarkedBlocks + report.strayEntries > 0
+            || report.countedFreeSpace != report.recordedFreeSpace) {
+            std::cout << "Wiersz " << command.line << ": dysk niespójny (uszkodzone łańcuchy: " << report.brokenChains
+                << ", skrzyżowane bloki: " << report.crossLinkedBlocks << ", wyciekłe bloki: " << report.leakedBlocks << ")!\n";
+            failedChecks++;
+        }
+    }
+    else if (name == "scrub") { Measure(name, [&] { fileManager.DisplayDiskScrub(); }); }
+    else if (name == "mspawn") {
+        const int pid = (int)Number(args[0]);
+        const std::string program = Payload(args[1]);
+        Measure(name, [&] { memoryManager.CreateProcess(pid, program); });
+    }
+    else if (name == "mload") {
+        const int pid = (int)Number(args[0]);
+        const int textSize = args.size() > 2 ? (int)Number(args[2]) : 0;
+        Measure(name, [&] { memoryManager.LoadProgram(pid, fileManager, args[1], textSize); });
+    }
+    else if (name == "mfork") {
+        const int parent = (int)Number(args[0]), child = (int)Number(args[1]);
+        Measure(name, [&] { memoryManager.Fork(parent, child); });
+    }
+    else if (name == "mkill") {
+        const int pid = (int)Number(args[0]);
+        Measure(name, [&] { memoryManager.RemoveProcess(pid); });
+    }
+    else if (name == "mread") {
+        const int pid = (int)Number(args[0]), address = (int)Number(args[1]);
+        Measure(name, [&] { memoryManager.Read(pid, address); });
+        bytesRead++;
+    }
+    else if (name == "mwrite") {
+        const int pid = (int)Number(args[0]), address = (int)Number(args[1]);
+        const std::string data = Payload(args[2]);
+        Measure(name, [&] { memoryManager.Write(pid, address, data.empty() ? '\0' : data[0]); });
+        bytesWritten++;
+    }
+    else if (name == "swap") {
+        const int slots = (int)Number(args[0]);
+        Measure(name, [&] { memoryManager.AttachSwap(fileManager, slots); });
+    }
+}
+
+template<typename Operation>
+void Driver::Measure(const std::string &name, const Operation &operation) {
+    //Wyciszenie komunikatów zarządców na czas operacji
+    std::streambuf* output = std::cout.rdbuf();
+    if (quiet) { std::cout.rdbuf(nullptr); }
+
+    const auto start = std::chrono::steady_clock::now();
+    operation();
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    if (quiet) {
+        std::cout.rdbuf(output);
+        std::cout.clear();
+    }
+    latencies[name].push_back(duration.count() * 1e6);
+    elapsed += duration.count();
+}
+
+const std::string Driver::Expand(const std::string &word) const {
+    std::string result;
+    for (size_t i = 0; i < word.size(); i++) {
+        if (word[i] != '$') {
+            result += word[i];
+            continue;
+        }
+        //Nazwa zmiennej to najdłuższy ciąg liter, cyfr i podkreśleń po $
+        size_t length = 0;
+        while (i + 1 + length < word.size() && (isalnum((unsigned char)word[i + 1 + length]) || word[i + 1 + length] == '_')) { length++; }
+        auto variable = variables.find(word.substr(i + 1, length));
+        if (variable != variables.end()) { result += std::to_string(variable->second); }
+        else { std::cout << "Nieznana zmienna '" << word.substr(i, length + 1) << "'!\n"; }
+        i += length;
+    }
+    return result;
+}
+
+const long long Driver::Number(const std::string &word) {
+    const long long bound = Generator(word, "rand");
+    if (bound > 0) { return std::uniform_int_distribution<long long>(0, bound - 1)(random); }
+
+    //Suma iloczynów liczb całkowitych
+    long long sum = 0, product = 1, number = 0;
+    for (size_t i = 0; i <= word.size(); i++) {
+        if (i < word.size() && isdigit((unsigned char)word[i])) { number = number * 10 + (word[i] - '0'); }
+        else {
+            product *= number;
+            number = 0;
+            if (i == word.size() || word[i] == '+') {
+                sum += product;
+                product = 1;
+            }
+        }
+    }
+    return sum;
+}
+
+const std::string Driver::Payload(const std::string &word) {
+    long long length;
+    if ((length = Generator(word, "gen")) >= 0) {
+        std::string data((size_t)length, '\0');
+        for (size_t i = 0; i < data.size(); i++) { data[i] = 'a' + i % 26; }
+        return data;
+    }
+    if ((length = Generator(word, "rand")) >= 0) {
+        std::string data((size_t)length, '\0');
+        std::uniform_int_distribution<int> letter('a', 'z');
+        for (char &c : data) { c = (char)letter(random); }
+        return data;
+    }
+    if ((length = Generator(word, "zero")) >= 0) { return std::string((size_t)length, '\0'); }
+    return word;
+}
+
+const long long Driver::Generator(const std::string &word, const std::string &name) {
+    if (word.size() < name.size() + 3 || word.compare(0, name.size() + 1, name + '(') != 0 || word.back() != ')') { return -1; }
+    const std::string digits = word.substr(name.size() + 1, word.size() - name.size() - 2);
+    if (!std::all_of(digits.begin(), digits.end(), [](const char &c) { return isdigit((unsigned char)c); })) { return -1; }
+    return std::stoll(digits);
+}
+
+void Driver::DisplayReport() const {
+    //Percentyl metodą najbliższej pozycji
+    const auto percentile = [](const std::vector<double> &sorted, const double &p) {
+        const size_t rank = (size_t)std::ceil(p * sorted.size());
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    };
+
+    std::vector<double> all;
+    for (const auto &entry : latencies) { all.insert(all.end(), entry.second.begin(), entry.second.end()); }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Operations: " << all.size() << " in " << elapsed * 1e3 << " ms ("
+        << (elapsed > 0 ? all.size() / elapsed : 0.0) << " ops/s)\n";
+    std::cout << "Bytes written: " << bytesWritten << ", read: " << bytesRead << '\n';
+    if (all.empty()) { return; }
+
+    std::cout << std::left << std::setw(10) << "Command" << std::right << std::setw(10) << "Count" << std::setw(14) << "ops/s"
+        << std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us" << '\n';
+    const auto row = [&](const std::string &name, std::vector<double> sorted) {
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0;
+        for (const double &latency : sorted) { total += latency; }
+        std::cout << std::left << std::setw(10) << name << std::right << std::setw(10) << sorted.size()
+            << std::setw(14) << (total > 0 ? sorted.size() / total * 1e6 : 0.0)
+            << std::setw(10) << percentile(sorted, 0.50) << std::setw(10) << percentile(sorted, 0.90)
+            << std::setw(10) << percentile(sorted, 0.99) << std::setw(10) << sorted.back() << '\n';
+    };
+    for (const auto &entry : latencies) { row(entry.first, entry.second); }
+    row("all", all);
+}
+
+int main(int argc, char* argv[]) {
+    bool quiet = false;
+    unsigned int seed = 0;
+    std::string path;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "-q") { quiet = true; }
+        else if (argument == "-s" && i + 1 < argc) { seed = (unsigned int)std::stoul(argv[++i]); }
+        else { path = argument; }
+    }
+
+    Driver driver(seed, quiet);
+    std::ifstream file;
+    if (!path.empty()) {
+        file.open(path);
+        if (!file) {
+            std::cout << "Nie można otworzyć skryptu '" << path << "'!\n";
+            return 1;
+        }
+    }
+    if (!driver.Load(path.empty() ? std::cin : file)) { return 1; }
+
+    const bool passed = driver.Run();
+    driver.DisplayReport();
+    return passed ? 0 : 1;
+}